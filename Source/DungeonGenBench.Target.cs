@@ -0,0 +1,25 @@
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Console program running the DungeonGenCore microbenchmarks and correctness checks, no editor, engine or RHI
+[SupportedPlatforms("Linux")]
+public class DungeonGenBenchTarget : TargetRules
+{
+	public DungeonGenBenchTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Program;
+		LinkType = TargetLinkType.Monolithic;
+		DefaultBuildSettings = BuildSettingsVersion.V4;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_3;
+		LaunchModuleName = "DungeonGenBench";
+
+		bBuildDeveloperTools = false;
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = false;
+		bCompileAgainstApplicationCore = false;
+		bCompileICU = false;
+		bCompileWithPluginSupport = false;
+		bUseLoggingInShipping = true;
+		bIsBuildingConsoleApplication = true;
+	}
+}
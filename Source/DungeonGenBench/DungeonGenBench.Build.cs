@@ -0,0 +1,14 @@
+using System.IO;
+using UnrealBuildTool;
+
+public class DungeonGenBench : ModuleRules
+{
+	public DungeonGenBench(ReadOnlyTargetRules Target) : base(Target)
+	{
+		// RequiredProgramMainCPPInclude.h lives with the launch module
+		PublicIncludePaths.Add(Path.Combine(EngineDirectory, "Source/Runtime/Launch/Public"));
+		PrivateIncludePaths.Add(Path.Combine(EngineDirectory, "Source/Runtime/Launch/Private"));
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "Projects", "DungeonGenCore" });
+	}
+}
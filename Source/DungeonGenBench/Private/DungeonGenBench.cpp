@@ -0,0 +1,46 @@
+#include "DungeonGenBench.h"
+#include "RequiredProgramMainCPPInclude.h"
+
+DEFINE_LOG_CATEGORY(LogDungeonGenBench);
+
+IMPLEMENT_APPLICATION(DungeonGenBench, "DungeonGenBench");
+
+// DungeonGenBench [-checks] [-bench] [-seed=N] [-iterations=N], runs both parts when neither is given
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV() {
+	FTaskTagScope Scope(ETaskTag::EGameThread);
+	ON_SCOPE_EXIT {
+		RequestEngineExit(TEXT("DungeonGenBench exiting"));
+		FEngineLoop::AppPreExit();
+		FModuleManager::Get().UnloadModulesAtShutdown();
+		FEngineLoop::AppExit();
+	};
+
+	if (int32 Result = GEngineLoop.PreInit(ArgC, ArgV)) {
+		return Result;
+	}
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	bool bRunChecks = FParse::Param(CommandLine, TEXT("checks"));
+	bool bRunBenchmarks = FParse::Param(CommandLine, TEXT("bench"));
+	if (!bRunChecks and !bRunBenchmarks) {
+		bRunChecks = bRunBenchmarks = true;
+	}
+
+	int32 Seed = 1337;
+	int32 Iterations = 10000;
+	FParse::Value(CommandLine, TEXT("seed="), Seed);
+	FParse::Value(CommandLine, TEXT("iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	int32 Failures = 0;
+	if (bRunChecks) {
+		Failures = DungeonGenBench::RunChecks(Seed);
+		UE_LOG(LogDungeonGenBench, Display, TEXT("Checks finished with %d failure(s)"), Failures);
+	}
+	if (bRunBenchmarks) {
+		DungeonGenBench::RunBenchmarks(Seed, Iterations);
+	}
+
+	GLog->Flush();
+	return Failures > 0 ? 1 : 0;
+}
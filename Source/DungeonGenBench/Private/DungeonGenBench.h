@@ -0,0 +1,13 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDungeonGenBench, Log, All);
+
+namespace DungeonGenBench {
+	// Run every correctness check, returns the number of failed expectations
+	int32 RunChecks(int32 Seed);
+
+	// Time each algorithm over Iterations calls and log the cost per call
+	void RunBenchmarks(int32 Seed, int32 Iterations);
+}
@@ -0,0 +1,124 @@
+#include "DungeonGenBench.h"
+#include "Generators/DungeonGrid.h"
+#include "Generators/DungeonGraph.h"
+#include "Generators/DungeonChunks.h"
+#include "Generators/DungeonSampling.h"
+#include "Generators/RoomShapeCache.h"
+
+namespace {
+	// Keeps results alive so the optimizer cannot drop the measured work
+	volatile int64 GBenchSink = 0;
+
+	void Measure(const TCHAR* Name, int32 Iterations, TFunctionRef<int64(int32 Iteration)> Body) {
+		// One untimed pass to warm caches and allocators
+		GBenchSink += Body(0);
+
+		const double StartTime = FPlatformTime::Seconds();
+		int64 Sink = 0;
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++) {
+			Sink += Body(Iteration);
+		}
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		GBenchSink += Sink;
+
+		UE_LOG(LogDungeonGenBench, Display, TEXT("%-32s %10d calls %12.1f ns/call %10.3f ms total"), Name, Iterations, Elapsed * 1e9 / Iterations, Elapsed * 1e3);
+	}
+
+	FRoomShapeKey MakeRandomKey(FRandomStream& Stream) {
+		FRoomShapeKey Key;
+		Key.ForwardWalls = Stream.RandRange(3, 11);
+		Key.RightWalls = Stream.RandRange(3, 11);
+		Key.EntranceSide = Stream.RandHelper(4);
+		Key.EntranceIndex = Stream.RandRange(1, DungeonGrid::WallsOnSide(static_cast<EDungeonOrientation>(Key.EntranceSide), Key.ForwardWalls, Key.RightWalls) - 1);
+		return Key;
+	}
+}
+
+void DungeonGenBench::RunBenchmarks(int32 Seed, int32 Iterations) {
+	FRandomStream Stream(Seed);
+
+	// Inputs are drawn up front so the stream never shows up in the timings
+	TArray<FRoomShapeKey> Keys;
+	for (int32 Index = 0; Index < 1024; Index++) {
+		Keys.Add(MakeRandomKey(Stream));
+	}
+
+	Measure(TEXT("Grid.SideWalk"), Iterations, [&Keys](int32 Iteration) {
+		const FRoomShapeKey& Key = Keys[Iteration & 1023];
+		int64 Sum = 0;
+		for (int32 SideIndex = 0; SideIndex < 4; SideIndex++) {
+			const EDungeonOrientation Side = static_cast<EDungeonOrientation>(SideIndex);
+			const FIntPoint SideStart = DungeonGrid::GetSideStart(Side, Key.ForwardWalls, Key.RightWalls);
+			for (int32 WallIndex = 0; WallIndex < DungeonGrid::WallsOnSide(Side, Key.ForwardWalls, Key.RightWalls); WallIndex++) {
+				const FIntPoint Point = DungeonGrid::GetWallPoint(Side, SideStart, WallIndex);
+				Sum += Point.X + Point.Y;
+			}
+		}
+		return Sum;
+		});
+
+	Measure(TEXT("Shapes.Build"), Iterations, [&Keys](int32 Iteration) {
+		return static_cast<int64>(FRoomShapeCache::Build(Keys[Iteration & 1023])->Pieces.Num());
+		});
+
+	FRoomShapeCache::Get().Reset();
+	Measure(TEXT("Shapes.FindOrBuild"), Iterations, [&Keys](int32 Iteration) {
+		return static_cast<int64>(FRoomShapeCache::Get().FindOrBuild(Keys[Iteration & 1023])->Pieces.Num());
+		});
+	FRoomShapeCache::Get().Reset();
+
+	// Tree shaped dungeon like the generator grows: room, entrance, corridor, room
+	FDungeonGraph Graph;
+	TArray<FDungeonNodeId> Rooms;
+	Rooms.Add(Graph.AddNode(EDungeonNodeType::Room));
+	for (int32 Index = 1; Index < 4096; Index++) {
+		const FDungeonNodeId Parent = Rooms[Stream.RandHelper(Rooms.Num())];
+		const FDungeonNodeId Entrance = Graph.AddNode(EDungeonNodeType::Entrance, NAME_None, Parent);
+		const FDungeonNodeId Corridor = Graph.AddNode(EDungeonNodeType::Corridor);
+		const FDungeonNodeId Room = Graph.AddNode(EDungeonNodeType::Room, Index % 97 == 0 ? FName(TEXT("Boss")) : NAME_None);
+		Graph.Connect(Parent, Entrance);
+		Graph.Connect(Entrance, Corridor);
+		Graph.Connect(Corridor, Room);
+		Rooms.Add(Room);
+	}
+
+	TArray<TPair<FDungeonNodeId, FDungeonNodeId>> Queries;
+	for (int32 Index = 0; Index < 1024; Index++) {
+		Queries.Emplace(Rooms[Stream.RandHelper(Rooms.Num())], Rooms[Stream.RandHelper(Rooms.Num())]);
+	}
+
+	const int32 GraphIterations = FMath::Max(Iterations / 10, 1);
+	Measure(TEXT("Graph.HopDistance"), GraphIterations, [&Graph, &Queries](int32 Iteration) {
+		const TPair<FDungeonNodeId, FDungeonNodeId>& Query = Queries[Iteration & 1023];
+		return static_cast<int64>(Graph.GetHopDistance(Query.Key, Query.Value));
+		});
+
+	TArray<FDungeonNodeId> Path;
+	Measure(TEXT("Graph.FindPath"), GraphIterations, [&Graph, &Queries, &Path](int32 Iteration) {
+		const TPair<FDungeonNodeId, FDungeonNodeId>& Query = Queries[Iteration & 1023];
+		Graph.FindPath(Query.Key, Query.Value, Path);
+		return static_cast<int64>(Path.Num());
+		});
+
+	Measure(TEXT("Graph.NearestTag"), GraphIterations, [&Graph, &Queries](int32 Iteration) {
+		return static_cast<int64>(Graph.FindNearestRoomWithTag(Queries[Iteration & 1023].Key, FName(TEXT("Boss"))));
+		});
+
+	Measure(TEXT("Graph.WithinHops"), Iterations, [&Graph, &Queries](int32 Iteration) {
+		int64 Visited = 0;
+		Graph.ForEachWithinHops(Queries[Iteration & 1023].Key, 6, [&Visited](const FDungeonNode&, int32 Hops) { Visited += Hops; });
+		return Visited;
+		});
+
+	const TArray<float> Weights = { 5.f, 1.f, 0.f, 3.f, 2.f, 8.f, 1.f, 4.f };
+	Measure(TEXT("Sampling.PickWeighted"), Iterations, [&Stream, &Weights](int32) {
+		return static_cast<int64>(DungeonSampling::PickWeighted(Stream, Weights));
+		});
+
+	Measure(TEXT("Chunks.PlanRoom"), Iterations, [Seed](int32 Iteration) {
+		FDungeonPlanKey Key;
+		Key.Cell = FIntPoint(Iteration % 160, Iteration / 160 % 160);
+		Key.Orientation = static_cast<EDungeonOrientation>(Iteration & 3);
+		return static_cast<int64>(FDungeonChunkCache::PlanRoom(FDungeonChunkCache::GetChunkSeed(Seed, FIntPoint(Iteration >> 8, 0)), Key).RoomSeed);
+		});
+}
@@ -0,0 +1,262 @@
+#include "DungeonGenBench.h"
+#include "Generators/DungeonGrid.h"
+#include "Generators/DungeonGraph.h"
+#include "Generators/DungeonChunks.h"
+#include "Generators/DungeonSampling.h"
+#include "Generators/RoomShapeCache.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace {
+	struct FCheckContext {
+		const TCHAR* Group = TEXT("");
+		int32 Passed = 0;
+		int32 Failures = 0;
+
+		void Expect(bool bCondition, const FString& What) {
+			if (bCondition) {
+				Passed++;
+				return;
+			}
+			Failures++;
+			UE_LOG(LogDungeonGenBench, Error, TEXT("[%s] %s"), Group, *What);
+		}
+	};
+
+	void CheckGrid(FCheckContext& Context) {
+		Context.Group = TEXT("Grid");
+
+		for (int32 Index = 0; Index < 4; Index++) {
+			const EDungeonOrientation Orientation = static_cast<EDungeonOrientation>(Index);
+			Context.Expect(DungeonGrid::FromYaw(DungeonGrid::ToYaw(Orientation)) == Orientation, FString::Printf(TEXT("FromYaw(ToYaw(%d)) does not round trip"), Index));
+			Context.Expect(DungeonGrid::FromYaw(DungeonGrid::ToYaw(Orientation) + 360.f) == Orientation, FString::Printf(TEXT("FromYaw ignores full turns for %d"), Index));
+			Context.Expect(DungeonGrid::Opposite(DungeonGrid::Opposite(Orientation)) == Orientation, FString::Printf(TEXT("Opposite is not an involution for %d"), Index));
+			Context.Expect(DungeonGrid::IsForwardAxis(Orientation) == DungeonGrid::IsForwardAxis(DungeonGrid::Opposite(Orientation)), FString::Printf(TEXT("Opposite changes the axis of %d"), Index));
+		}
+
+		EDungeonOrientation Parsed;
+		Context.Expect(!DungeonGrid::TryFromYaw(45.f, Parsed), TEXT("TryFromYaw accepts 45 degrees"));
+		Context.Expect(DungeonGrid::TryFromYaw(-89.5f, Parsed) and Parsed == EDungeonOrientation::Left, TEXT("TryFromYaw rejects -89.5 degrees"));
+
+		// Wall points and their inverse, in local space and through a rotated world transform
+		const FVector Origin(1234.f, -567.f, 89.f);
+		const FRotator Rotation(0.f, 90.f, 0.f);
+		const float WallLength = 400.f;
+		for (int32 ForwardWalls = 3; ForwardWalls < 12; ForwardWalls++) {
+			for (int32 RightWalls = 3; RightWalls < 12; RightWalls++) {
+				for (int32 SideIndex = 0; SideIndex < 4; SideIndex++) {
+					const EDungeonOrientation Side = static_cast<EDungeonOrientation>(SideIndex);
+					const FIntPoint SideStart = DungeonGrid::GetSideStart(Side, ForwardWalls, RightWalls);
+					for (int32 WallIndex = 0; WallIndex < DungeonGrid::WallsOnSide(Side, ForwardWalls, RightWalls); WallIndex++) {
+						const FIntPoint Point = DungeonGrid::GetWallPoint(Side, SideStart, WallIndex);
+						const FVector World = DungeonGrid::ToWorldLocation(Origin, Rotation, Point, WallLength);
+						if (DungeonGrid::GetWallIndex(Side, SideStart, Point) != WallIndex or DungeonGrid::ToLatticePoint(Origin, Rotation, World, WallLength) != Point) {
+							Context.Expect(false, FString::Printf(TEXT("Wall %d on side %d of a %dx%d room does not round trip"), WallIndex, SideIndex, ForwardWalls, RightWalls));
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void CheckShapes(FCheckContext& Context, FRandomStream& Stream) {
+		Context.Group = TEXT("Shapes");
+
+		FRoomShapeCache::Get().Reset();
+		for (int32 Round = 0; Round < 200; Round++) {
+			FRoomShapeKey Key;
+			Key.ForwardWalls = Stream.RandRange(3, 11);
+			Key.RightWalls = Stream.RandRange(3, 11);
+			if (Stream.FRand() < 0.75f) {
+				Key.EntranceSide = Stream.RandHelper(4);
+				Key.EntranceIndex = Stream.RandRange(1, DungeonGrid::WallsOnSide(static_cast<EDungeonOrientation>(Key.EntranceSide), Key.ForwardWalls, Key.RightWalls) - 1);
+			}
+
+			// Entrances of the other sides are cut in on top of the template
+			FRoomShapeEntrances Extra;
+			int32 Entrances = Key.EntranceSide != INDEX_NONE ? 1 : 0;
+			for (int32 SideIndex = 0; SideIndex < 4; SideIndex++) {
+				if (SideIndex != Key.EntranceSide and Stream.FRand() < 0.5f) {
+					const int32 Walls = DungeonGrid::WallsOnSide(static_cast<EDungeonOrientation>(SideIndex), Key.ForwardWalls, Key.RightWalls);
+					Extra.Indices[SideIndex] = Stream.RandRange(1, Walls - 1);
+					Entrances++;
+				}
+			}
+
+			TSharedRef<const FRoomShapeTemplate> Shape = FRoomShapeCache::Get().FindOrBuild(Key);
+			Context.Expect(FRoomShapeCache::Get().FindOrBuild(Key) == Shape, TEXT("FindOrBuild returns a different template for the same key"));
+			Context.Expect(Shape->Pieces.Num() == 2 * (Key.ForwardWalls + Key.RightWalls), FString::Printf(TEXT("%dx%d shape has %d pieces"), Key.ForwardWalls, Key.RightWalls, Shape->Pieces.Num()));
+
+			// Every piece on its own cell, one entrance per open side
+			TSet<FIntPoint> Cells;
+			int32 EntrancePieces = 0;
+			for (const FRoomShapePiece& Piece : Shape->Pieces) {
+				Cells.Add(Piece.Cell);
+				EntrancePieces += Extra.IsEntrance(Piece) ? 1 : 0;
+			}
+			Context.Expect(Cells.Num() == Shape->Pieces.Num(), FString::Printf(TEXT("%dx%d shape has overlapping pieces"), Key.ForwardWalls, Key.RightWalls));
+			Context.Expect(EntrancePieces == Entrances, FString::Printf(TEXT("%dx%d shape has %d entrances, expected %d"), Key.ForwardWalls, Key.RightWalls, EntrancePieces, Entrances));
+		}
+		FRoomShapeCache::Get().Reset();
+	}
+
+	// Hop distances by a plain breadth-first search over the edge list, the reference for the graph
+	TArray<int32> ReferenceDistances(int32 NodeCount, const TArray<TPair<int32, int32>>& Edges, int32 From) {
+		TArray<int32> Distances;
+		Distances.Init(INDEX_NONE, NodeCount);
+		Distances[From] = 0;
+		for (bool bChanged = true; bChanged;) {
+			bChanged = false;
+			for (const TPair<int32, int32>& Edge : Edges) {
+				for (int32 Side = 0; Side < 2; Side++) {
+					const int32 A = Side ? Edge.Value : Edge.Key;
+					const int32 B = Side ? Edge.Key : Edge.Value;
+					if (Distances[A] != INDEX_NONE and (Distances[B] == INDEX_NONE or Distances[B] > Distances[A] + 1)) {
+						Distances[B] = Distances[A] + 1;
+						bChanged = true;
+					}
+				}
+			}
+		}
+		return Distances;
+	}
+
+	void CheckGraph(FCheckContext& Context, FRandomStream& Stream) {
+		Context.Group = TEXT("Graph");
+
+		for (int32 Round = 0; Round < 20; Round++) {
+			const int32 NodeCount = Stream.RandRange(2, 120);
+			FDungeonGraph Graph;
+			TArray<FDungeonNodeId> Ids;
+			for (int32 Index = 0; Index < NodeCount; Index++) {
+				Ids.Add(Graph.AddNode(EDungeonNodeType::Room, Index % 7 == 6 ? FName(TEXT("Boss")) : NAME_None));
+			}
+
+			// Sparse random graph, not necessarily connected
+			TArray<TPair<int32, int32>> Edges;
+			for (int32 Edge = 0; Edge < NodeCount; Edge++) {
+				const int32 A = Stream.RandHelper(NodeCount);
+				const int32 B = Stream.RandHelper(NodeCount);
+				Graph.Connect(Ids[A], Ids[B]);
+				if (A != B) {
+					Edges.Emplace(A, B);
+				}
+			}
+
+			const int32 From = Stream.RandHelper(NodeCount);
+			const TArray<int32> Expected = ReferenceDistances(NodeCount, Edges, From);
+			int32 NearestBoss = INDEX_NONE;
+			for (int32 Index = 0; Index < NodeCount; Index++) {
+				Context.Expect(Graph.GetHopDistance(Ids[From], Ids[Index]) == Expected[Index], FString::Printf(TEXT("Hop distance %d -> %d differs from the reference"), From, Index));
+
+				TArray<FDungeonNodeId> Path;
+				const bool bFound = Graph.FindPath(Ids[From], Ids[Index], Path);
+				Context.Expect(bFound == (Expected[Index] != INDEX_NONE) and (!bFound or Path.Num() == Expected[Index] + 1), FString::Printf(TEXT("Path %d -> %d has the wrong length"), From, Index));
+
+				if (Index % 7 == 6 and Expected[Index] != INDEX_NONE and (NearestBoss == INDEX_NONE or Expected[Index] < NearestBoss)) {
+					NearestBoss = Expected[Index];
+				}
+			}
+
+			int32 Hops = INDEX_NONE;
+			const FDungeonNodeId Boss = Graph.FindNearestRoomWithTag(Ids[From], FName(TEXT("Boss")), &Hops);
+			Context.Expect((Boss == INDEX_NONE) == (NearestBoss == INDEX_NONE) and (Boss == INDEX_NONE or Hops == NearestBoss), TEXT("FindNearestRoomWithTag misses the closest tagged room"));
+
+			int32 Visited = 0;
+			Graph.ForEachWithinHops(Ids[From], 2, [&Visited](const FDungeonNode&, int32) { Visited++; });
+			Context.Expect(Visited == Expected.FilterByPredicate([](int32 Distance) { return Distance != INDEX_NONE and Distance <= 2; }).Num(), TEXT("ForEachWithinHops visits the wrong number of nodes"));
+		}
+
+		// Removing a room removes the entrances it owns and every edge touching them
+		FDungeonGraph Graph;
+		const FDungeonNodeId Room = Graph.AddNode(EDungeonNodeType::Room);
+		const FDungeonNodeId Entrance = Graph.AddNode(EDungeonNodeType::Entrance, NAME_None, Room);
+		const FDungeonNodeId Corridor = Graph.AddNode(EDungeonNodeType::Corridor);
+		Graph.Connect(Room, Entrance);
+		Graph.Connect(Entrance, Corridor);
+		Graph.RemoveNode(Room);
+		TArray<FDungeonNodeId> Neighbours;
+		Graph.GetNeighbours(Corridor, Neighbours);
+		Context.Expect(Graph.Num() == 1 and !Graph.Contains(Entrance) and Neighbours.Num() == 0, TEXT("RemoveNode leaves owned nodes or edges behind"));
+	}
+
+	void CheckSampling(FCheckContext& Context, FRandomStream& Stream) {
+		Context.Group = TEXT("Sampling");
+
+		const TArray<float> Empty;
+		const TArray<float> Zeroes = { 0.f, 0.f };
+		Context.Expect(DungeonSampling::PickWeighted(Stream, Empty) == INDEX_NONE, TEXT("Empty weights pick an index"));
+		Context.Expect(DungeonSampling::PickWeighted(Stream, Zeroes) == INDEX_NONE, TEXT("Zero weights pick an index"));
+
+		// Frequencies follow the weights, zero weights are never picked
+		const TArray<float> Weights = { 1.f, 0.f, 3.f, 6.f, 0.f };
+		int32 Counts[5] = {};
+		const int32 Draws = 100000;
+		for (int32 Draw = 0; Draw < Draws; Draw++) {
+			Counts[DungeonSampling::PickWeighted(Stream, Weights)]++;
+		}
+		Context.Expect(Counts[1] == 0 and Counts[4] == 0, TEXT("A zero weight was picked"));
+		for (int32 Index : { 0, 2, 3 }) {
+			const float Frequency = static_cast<float>(Counts[Index]) / Draws;
+			Context.Expect(FMath::IsNearlyEqual(Frequency, Weights[Index] / 10.f, 0.01f), FString::Printf(TEXT("Index %d picked with frequency %.4f, expected %.4f"), Index, Frequency, Weights[Index] / 10.f));
+		}
+
+		// Same seed, same picks
+		FRandomStream A(Stream.GetCurrentSeed());
+		FRandomStream B(Stream.GetCurrentSeed());
+		bool bSame = true;
+		for (int32 Draw = 0; Draw < 1000; Draw++) {
+			bSame &= DungeonSampling::PickWeighted(A, Weights) == DungeonSampling::PickWeighted(B, Weights);
+		}
+		Context.Expect(bSame, TEXT("Picks are not reproducible from a seed"));
+	}
+
+	void CheckChunks(FCheckContext& Context, FRandomStream& Stream) {
+		Context.Group = TEXT("Chunks");
+
+		FDungeonChunkLayout Layout;
+		for (int32 Round = 0; Round < 1000; Round++) {
+			const int32 ChunkSeed = FDungeonChunkCache::GetChunkSeed(Stream.RandHelper(MAX_int32), FIntPoint(Stream.RandRange(-50, 50), Stream.RandRange(-50, 50)));
+			FDungeonPlanKey Key;
+			Key.Cell = FIntPoint(Stream.RandHelper(160), Stream.RandHelper(160));
+			Key.Orientation = static_cast<EDungeonOrientation>(Stream.RandHelper(4));
+
+			const FDungeonRoomPlan Plan = FDungeonChunkCache::PlanRoom(ChunkSeed, Key);
+			const FDungeonRoomPlan Again = FDungeonChunkCache::PlanRoom(ChunkSeed, Key);
+			Context.Expect(FMemory::Memcmp(&Plan, &Again, sizeof(Plan)) == 0, TEXT("PlanRoom is not deterministic"));
+			Context.Expect(Plan.CorridorWalls >= 3 and Plan.CorridorWalls < 12 and Plan.ForwardWalls >= 3 and Plan.ForwardWalls < 12 and Plan.RightWalls >= 3 and Plan.RightWalls < 12, TEXT("Planned wall counts out of range"));
+
+			const int32 Walls = DungeonGrid::IsForwardAxis(Key.Orientation) ? Plan.ForwardWalls : Plan.RightWalls;
+			Context.Expect(Plan.EntranceIndex >= 1 and Plan.EntranceIndex < Walls, FString::Printf(TEXT("Entrance %d outside a side of %d walls"), Plan.EntranceIndex, Walls));
+			Layout.Rooms.Add(Key, Plan);
+		}
+
+		// Layouts survive a round trip through an archive
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Writer << Layout;
+		FDungeonChunkLayout Loaded;
+		FMemoryReader Reader(Bytes);
+		Reader << Loaded;
+		bool bSame = !Reader.IsError() and Loaded.Rooms.Num() == Layout.Rooms.Num();
+		for (const TPair<FDungeonPlanKey, FDungeonRoomPlan>& Room : Layout.Rooms) {
+			const FDungeonRoomPlan* Found = Loaded.Rooms.Find(Room.Key);
+			bSame &= Found and FMemory::Memcmp(Found, &Room.Value, sizeof(FDungeonRoomPlan)) == 0;
+		}
+		Context.Expect(bSame, TEXT("Chunk layout does not survive serialization"));
+	}
+}
+
+int32 DungeonGenBench::RunChecks(int32 Seed) {
+	FCheckContext Context;
+	FRandomStream Stream(Seed);
+
+	CheckGrid(Context);
+	CheckShapes(Context, Stream);
+	CheckGraph(Context, Stream);
+	CheckSampling(Context, Stream);
+	CheckChunks(Context, Stream);
+
+	UE_LOG(LogDungeonGenBench, Display, TEXT("%d expectations passed, %d failed (seed %d)"), Context.Passed, Context.Failures, Seed);
+	return Context.Failures;
+}
@@ -0,0 +1,13 @@
+using UnrealBuildTool;
+
+// Layout, sampling, grid and routing algorithms of the dungeon generators.
+// Depends on Core only, so it links into the game module and into the DungeonGenBench program alike
+public class DungeonGenCore : ModuleRules
+{
+	public DungeonGenCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
@@ -0,0 +1,132 @@
+#include "Generators/DungeonChunks.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDungeonChunks, Log, All);
+
+namespace {
+	constexpr uint32 CacheMagic = 0x48434744; // "DGCH"
+	constexpr int32 CacheVersion = 1;
+}
+
+void FDungeonChunkCache::Initialize(int32 InWorldSeed, float InChunkSize) {
+	WorldSeed = InWorldSeed;
+	ChunkSize = FMath::Max(InChunkSize, PlanCellSize);
+	Chunks.Reset();
+	bDirty = false;
+	CacheHits = 0;
+}
+
+FIntPoint FDungeonChunkCache::GetChunkCoord(const FVector& Location) const {
+	return FIntPoint(FMath::FloorToInt(Location.X / ChunkSize), FMath::FloorToInt(Location.Y / ChunkSize));
+}
+
+int32 FDungeonChunkCache::GetChunkSeed(int32 WorldSeed, FIntPoint Chunk) {
+	return static_cast<int32>(HashCombine(GetTypeHash(WorldSeed), GetTypeHash(Chunk)));
+}
+
+FDungeonRoomPlan FDungeonChunkCache::FindOrPlanRoom(const FVector& EntranceLocation, EDungeonOrientation Orientation) {
+	const FIntPoint Chunk = GetChunkCoord(EntranceLocation);
+	const FVector Local = EntranceLocation - FVector(Chunk.X * ChunkSize, Chunk.Y * ChunkSize, 0.f);
+
+	FDungeonPlanKey Key;
+	Key.Cell = FIntPoint(FMath::RoundToInt(Local.X / PlanCellSize), FMath::RoundToInt(Local.Y / PlanCellSize));
+	Key.Orientation = Orientation;
+
+	FDungeonChunkLayout& Layout = Chunks.FindOrAdd(Chunk);
+	if (const FDungeonRoomPlan* Found = Layout.Rooms.Find(Key)) {
+		CacheHits++;
+		return *Found;
+	}
+
+	const FDungeonRoomPlan Plan = PlanRoom(GetChunkSeed(WorldSeed, Chunk), Key);
+	Layout.Rooms.Add(Key, Plan);
+	bDirty = true;
+	return Plan;
+}
+
+FDungeonRoomPlan FDungeonChunkCache::PlanRoom(int32 ChunkSeed, const FDungeonPlanKey& Key) {
+	FRandomStream Stream(static_cast<int32>(HashCombine(static_cast<uint32>(ChunkSeed), GetTypeHash(Key))));
+
+	// Same ranges and draws the dungeon used to make from its own stream
+	FDungeonRoomPlan Plan;
+	Plan.CorridorWalls = static_cast<uint8>(Stream.FRandRange(3.f, 12.f));
+	Plan.ForwardWalls = static_cast<uint8>(Stream.FRandRange(3.f, 12.f));
+	Plan.RightWalls = static_cast<uint8>(Stream.FRandRange(3.f, 12.f));
+
+	// Entrances facing forward / back sit on a forward side
+	const int32 Walls = DungeonGrid::IsForwardAxis(Key.Orientation) ? Plan.ForwardWalls : Plan.RightWalls;
+	Plan.EntranceIndex = static_cast<uint8>(Walls - Stream.RandRange(1, Walls - 1));
+	Plan.RoomSeed = Stream.RandHelper(MAX_int32);
+	return Plan;
+}
+
+FString FDungeonChunkCache::GetCacheFilename() const {
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DungeonCache"), FString::Printf(TEXT("Layout_%d.bin"), WorldSeed));
+}
+
+int32 FDungeonChunkCache::GetPlannedRoomCount() const {
+	int32 Rooms = 0;
+	for (const TPair<FIntPoint, FDungeonChunkLayout>& Chunk : Chunks) {
+		Rooms += Chunk.Value.Rooms.Num();
+	}
+	return Rooms;
+}
+
+bool FDungeonChunkCache::Load() {
+	const FString Filename = GetCacheFilename();
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename, FILEREAD_Silent)) {
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 FileSeed = 0;
+	float FileChunkSize = 0.f;
+	Reader << Magic << Version << FileSeed << FileChunkSize;
+
+	// A different chunk size puts entrances in different cells, such a file cannot be reused
+	if (Magic != CacheMagic or Version != CacheVersion or FileSeed != WorldSeed or FileChunkSize != ChunkSize) {
+		UE_LOG(LogDungeonChunks, Warning, TEXT("Ignoring layout cache %s, it was written for another seed, chunk size or version"), *Filename);
+		return false;
+	}
+
+	TMap<FIntPoint, FDungeonChunkLayout> Loaded;
+	Reader << Loaded;
+	if (Reader.IsError()) {
+		UE_LOG(LogDungeonChunks, Warning, TEXT("Layout cache %s is corrupt"), *Filename);
+		return false;
+	}
+
+	Chunks = MoveTemp(Loaded);
+	bDirty = false;
+	UE_LOG(LogDungeonChunks, Log, TEXT("Loaded %d chunks, %d planned rooms from %s"), Chunks.Num(), GetPlannedRoomCount(), *Filename);
+	return true;
+}
+
+bool FDungeonChunkCache::Save() {
+	if (!bDirty) {
+		return true;
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	uint32 Magic = CacheMagic;
+	int32 Version = CacheVersion;
+	Writer << Magic << Version << WorldSeed << ChunkSize;
+	Writer << Chunks;
+
+	const FString Filename = GetCacheFilename();
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Filename)) {
+		UE_LOG(LogDungeonChunks, Warning, TEXT("Could not write layout cache %s"), *Filename);
+		return false;
+	}
+
+	bDirty = false;
+	UE_LOG(LogDungeonChunks, Log, TEXT("Saved %d chunks, %d planned rooms to %s (%d bytes)"), Chunks.Num(), GetPlannedRoomCount(), *Filename, Bytes.Num());
+	return true;
+}
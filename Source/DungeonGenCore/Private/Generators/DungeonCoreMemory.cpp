@@ -0,0 +1,3 @@
+#include "Generators/DungeonCoreMemory.h"
+
+LLM_DEFINE_TAG(DungeonLayout);
@@ -0,0 +1,228 @@
+#include "Generators/DungeonGraph.h"
+#include "Algo/Reverse.h"
+
+FDungeonNodeId FDungeonGraph::AddNode(EDungeonNodeType Type, FName Tag, FDungeonNodeId OwnerId) {
+	FDungeonNode Node;
+	Node.Id = NextId++;
+	Node.Type = Type;
+	Node.Tag = Tag;
+	Node.OwnerId = OwnerId;
+
+	IdToIndex.Add(Node.Id, Nodes.Add(Node));
+	bAdjacencyDirty = true;
+	return Node.Id;
+}
+
+void FDungeonGraph::RemoveNode(FDungeonNodeId Id) {
+	const int32* IndexPtr = IdToIndex.Find(Id);
+	if (!IndexPtr) {
+		return;
+	}
+
+	// Collect the node and everything it owns first, owners are always added before what they own
+	TArray<FDungeonNodeId, TInlineAllocator<16>> ToRemove;
+	ToRemove.Add(Id);
+	for (const FDungeonNode& Node : Nodes) {
+		if (Node.OwnerId == Id) {
+			ToRemove.Add(Node.Id);
+		}
+	}
+
+	for (FDungeonNodeId RemovedId : ToRemove) {
+		const int32 Index = IdToIndex.FindAndRemoveChecked(RemovedId);
+		Nodes.RemoveAtSwap(Index, 1, false);
+		if (Nodes.IsValidIndex(Index)) {
+			IdToIndex[Nodes[Index].Id] = Index;
+		}
+	}
+
+	Edges.RemoveAllSwap([this, &ToRemove](const TPair<FDungeonNodeId, FDungeonNodeId>& Edge) {
+		if (ToRemove.Contains(Edge.Key) or ToRemove.Contains(Edge.Value)) {
+			EdgeKeys.Remove(MakeEdgeKey(Edge.Key, Edge.Value));
+			return true;
+		}
+		return false;
+		});
+
+	bAdjacencyDirty = true;
+}
+
+void FDungeonGraph::Connect(FDungeonNodeId A, FDungeonNodeId B) {
+	if (A == B or !Contains(A) or !Contains(B)) {
+		return;
+	}
+
+	// Store edges normalized so duplicates are easy to spot
+	const FDungeonNodeId Low = FMath::Min(A, B);
+	const FDungeonNodeId High = FMath::Max(A, B);
+	bool bAlreadyConnected = false;
+	EdgeKeys.Add(MakeEdgeKey(Low, High), &bAlreadyConnected);
+	if (!bAlreadyConnected) {
+		Edges.Emplace(Low, High);
+		bAdjacencyDirty = true;
+	}
+}
+
+const FDungeonNode* FDungeonGraph::GetNode(FDungeonNodeId Id) const {
+	const int32* Index = IdToIndex.Find(Id);
+	return Index ? &Nodes[*Index] : nullptr;
+}
+
+SIZE_T FDungeonGraph::GetAllocatedSize() const {
+	return Nodes.GetAllocatedSize() + IdToIndex.GetAllocatedSize() + Edges.GetAllocatedSize() + EdgeKeys.GetAllocatedSize()
+		+ AdjacencyOffsets.GetAllocatedSize() + AdjacencyTargets.GetAllocatedSize()
+		+ Distances.GetAllocatedSize() + Parents.GetAllocatedSize() + Frontier.GetAllocatedSize();
+}
+
+void FDungeonGraph::Reset() {
+	Nodes.Reset();
+	IdToIndex.Reset();
+	Edges.Reset();
+	EdgeKeys.Reset();
+	bAdjacencyDirty = true;
+}
+
+void FDungeonGraph::RebuildAdjacency() const {
+	const int32 NodeCount = Nodes.Num();
+
+	// Counting sort of edge endpoints into the offsets array
+	AdjacencyOffsets.Reset();
+	AdjacencyOffsets.SetNumZeroed(NodeCount + 1);
+	for (const TPair<FDungeonNodeId, FDungeonNodeId>& Edge : Edges) {
+		AdjacencyOffsets[IdToIndex[Edge.Key] + 1]++;
+		AdjacencyOffsets[IdToIndex[Edge.Value] + 1]++;
+	}
+	for (int32 Index = 0; Index < NodeCount; Index++) {
+		AdjacencyOffsets[Index + 1] += AdjacencyOffsets[Index];
+	}
+
+	AdjacencyTargets.SetNumUninitialized(Edges.Num() * 2, false);
+	TArray<int32, TInlineAllocator<256>> Cursor;
+	Cursor.Append(AdjacencyOffsets.GetData(), NodeCount);
+	for (const TPair<FDungeonNodeId, FDungeonNodeId>& Edge : Edges) {
+		const int32 A = IdToIndex[Edge.Key];
+		const int32 B = IdToIndex[Edge.Value];
+		AdjacencyTargets[Cursor[A]++] = B;
+		AdjacencyTargets[Cursor[B]++] = A;
+	}
+
+	bAdjacencyDirty = false;
+}
+
+int32 FDungeonGraph::Search(int32 FromIndex, int32 MaxHops, TFunctionRef<bool(int32 NodeIndex, int32 Hops)> ShouldStop) const {
+	if (bAdjacencyDirty) {
+		RebuildAdjacency();
+	}
+
+	const int32 NodeCount = Nodes.Num();
+	Distances.Init(INDEX_NONE, NodeCount);
+	Parents.Init(INDEX_NONE, NodeCount);
+	Frontier.Reset(NodeCount);
+
+	Distances[FromIndex] = 0;
+	Frontier.Add(FromIndex);
+
+	// Frontier doubles as the queue, ReadIndex walks it front to back
+	for (int32 ReadIndex = 0; ReadIndex < Frontier.Num(); ReadIndex++) {
+		const int32 Current = Frontier[ReadIndex];
+		const int32 Hops = Distances[Current];
+
+		if (ShouldStop(Current, Hops)) {
+			return Current;
+		}
+		if (Hops >= MaxHops) {
+			continue;
+		}
+
+		for (int32 Edge = AdjacencyOffsets[Current]; Edge < AdjacencyOffsets[Current + 1]; Edge++) {
+			const int32 Next = AdjacencyTargets[Edge];
+			if (Distances[Next] == INDEX_NONE) {
+				Distances[Next] = Hops + 1;
+				Parents[Next] = Current;
+				Frontier.Add(Next);
+			}
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FDungeonGraph::GetHopDistance(FDungeonNodeId From, FDungeonNodeId To) const {
+	const int32* FromIndex = IdToIndex.Find(From);
+	const int32* ToIndex = IdToIndex.Find(To);
+	if (!FromIndex or !ToIndex) {
+		return INDEX_NONE;
+	}
+
+	const int32 Target = *ToIndex;
+	const int32 Found = Search(*FromIndex, MAX_int32, [Target](int32 NodeIndex, int32) { return NodeIndex == Target; });
+	return Found == INDEX_NONE ? INDEX_NONE : Distances[Found];
+}
+
+FDungeonNodeId FDungeonGraph::FindNearestRoomWithTag(FDungeonNodeId From, FName Tag, int32* OutHops) const {
+	const int32* FromIndex = IdToIndex.Find(From);
+	if (!FromIndex) {
+		return INDEX_NONE;
+	}
+
+	const int32 Found = Search(*FromIndex, MAX_int32, [this, Tag](int32 NodeIndex, int32) {
+		return Nodes[NodeIndex].Type == EDungeonNodeType::Room and Nodes[NodeIndex].Tag == Tag;
+		});
+
+	if (Found == INDEX_NONE) {
+		return INDEX_NONE;
+	}
+	if (OutHops) {
+		*OutHops = Distances[Found];
+	}
+	return Nodes[Found].Id;
+}
+
+bool FDungeonGraph::FindPath(FDungeonNodeId From, FDungeonNodeId To, TArray<FDungeonNodeId>& OutPath) const {
+	OutPath.Reset();
+
+	const int32* FromIndex = IdToIndex.Find(From);
+	const int32* ToIndex = IdToIndex.Find(To);
+	if (!FromIndex or !ToIndex) {
+		return false;
+	}
+
+	const int32 Target = *ToIndex;
+	if (Search(*FromIndex, MAX_int32, [Target](int32 NodeIndex, int32) { return NodeIndex == Target; }) == INDEX_NONE) {
+		return false;
+	}
+
+	// Walk parents back from the target, then flip
+	for (int32 Index = Target; Index != INDEX_NONE; Index = Parents[Index]) {
+		OutPath.Add(Nodes[Index].Id);
+	}
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+void FDungeonGraph::ForEachWithinHops(FDungeonNodeId From, int32 MaxHops, TFunctionRef<void(const FDungeonNode& Node, int32 Hops)> Visitor) const {
+	const int32* FromIndex = IdToIndex.Find(From);
+	if (!FromIndex) {
+		return;
+	}
+
+	Search(*FromIndex, MaxHops, [this, &Visitor](int32 NodeIndex, int32 Hops) {
+		Visitor(Nodes[NodeIndex], Hops);
+		return false;
+		});
+}
+
+void FDungeonGraph::GetNeighbours(FDungeonNodeId Id, TArray<FDungeonNodeId>& OutNeighbours) const {
+	OutNeighbours.Reset();
+
+	const int32* Index = IdToIndex.Find(Id);
+	if (!Index) {
+		return;
+	}
+	if (bAdjacencyDirty) {
+		RebuildAdjacency();
+	}
+
+	for (int32 Edge = AdjacencyOffsets[*Index]; Edge < AdjacencyOffsets[*Index + 1]; Edge++) {
+		OutNeighbours.Add(Nodes[AdjacencyTargets[Edge]].Id);
+	}
+}
@@ -0,0 +1,29 @@
+#include "Generators/DungeonSampling.h"
+
+int32 DungeonSampling::PickWeighted(FRandomStream& Stream, TArrayView<const float> Weights) {
+	float TotalWeight = 0.f;
+	int32 LastPositive = INDEX_NONE;
+	for (int32 Index = 0; Index < Weights.Num(); Index++) {
+		if (Weights[Index] > 0.f) {
+			TotalWeight += Weights[Index];
+			LastPositive = Index;
+		}
+	}
+
+	float RandomValue = Stream.FRandRange(0.f, TotalWeight);
+	if (LastPositive == INDEX_NONE) {
+		return INDEX_NONE;
+	}
+
+	for (int32 Index = 0; Index < LastPositive; Index++) {
+		if (Weights[Index] > 0.f) {
+			RandomValue -= Weights[Index];
+			if (RandomValue < 0.f) {
+				return Index;
+			}
+		}
+	}
+
+	// Rounding may leave a sliver of the range past the last subtraction
+	return LastPositive;
+}
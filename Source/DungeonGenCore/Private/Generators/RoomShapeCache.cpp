@@ -0,0 +1,73 @@
+#include "Generators/RoomShapeCache.h"
+#include "Generators/DungeonCoreMemory.h"
+
+FRoomShapeCache& FRoomShapeCache::Get() {
+	static FRoomShapeCache Instance;
+	return Instance;
+}
+
+TSharedRef<const FRoomShapeTemplate> FRoomShapeCache::FindOrBuild(const FRoomShapeKey& Key) {
+	LLM_SCOPE_BYTAG(DungeonLayout);
+
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const TSharedRef<const FRoomShapeTemplate>* Found = Templates.Find(Key)) {
+			return *Found;
+		}
+	}
+
+	// Built outside the lock, a racing thread may have added the same key meanwhile
+	TSharedRef<const FRoomShapeTemplate> Built = Build(Key);
+
+	FWriteScopeLock WriteLock(Lock);
+	if (const TSharedRef<const FRoomShapeTemplate>* Found = Templates.Find(Key)) {
+		return *Found;
+	}
+	Templates.Add(Key, Built);
+	return Built;
+}
+
+TSharedRef<const FRoomShapeTemplate> FRoomShapeCache::Build(const FRoomShapeKey& Key) {
+	TSharedRef<FRoomShapeTemplate> Shape = MakeShared<FRoomShapeTemplate>();
+	Shape->Key = Key;
+	Shape->Pieces.Reserve(2 * (Key.ForwardWalls + Key.RightWalls));
+
+	for (int32 SideIndex = 0; SideIndex < 4; SideIndex++) {
+		const EDungeonOrientation Side = static_cast<EDungeonOrientation>(SideIndex);
+		const int32 NumberOfWalls = DungeonGrid::WallsOnSide(Side, Key.ForwardWalls, Key.RightWalls);
+		const FIntPoint SideStart = DungeonGrid::GetSideStart(Side, Key.ForwardWalls, Key.RightWalls);
+
+		for (int32 WallIndex = 0; WallIndex < NumberOfWalls; WallIndex++) {
+			FRoomShapePiece& Piece = Shape->Pieces.AddDefaulted_GetRef();
+			Piece.Cell = DungeonGrid::GetWallPoint(Side, SideStart, WallIndex);
+			Piece.Side = Side;
+			Piece.WallIndex = WallIndex;
+			Piece.Category = SideIndex == Key.EntranceSide and WallIndex == Key.EntranceIndex ? ERoomPieceCategory::Entrance : ERoomPieceCategory::Wall;
+
+			// Every third wall takes the lighted variant, unless it is the entrance
+			if (WallIndex % 3 == 0 and Piece.Category == ERoomPieceCategory::Wall) {
+				Piece.Flags = ERoomPieceFlags::LightSlot;
+			}
+		}
+	}
+	return Shape;
+}
+
+int32 FRoomShapeCache::Num() const {
+	FReadScopeLock ReadLock(Lock);
+	return Templates.Num();
+}
+
+SIZE_T FRoomShapeCache::GetAllocatedSize() const {
+	FReadScopeLock ReadLock(Lock);
+	SIZE_T Bytes = Templates.GetAllocatedSize();
+	for (const TPair<FRoomShapeKey, TSharedRef<const FRoomShapeTemplate>>& Template : Templates) {
+		Bytes += sizeof(FRoomShapeTemplate) + Template.Value->Pieces.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+void FRoomShapeCache::Reset() {
+	FWriteScopeLock WriteLock(Lock);
+	Templates.Reset();
+}
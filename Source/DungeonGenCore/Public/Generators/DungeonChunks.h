@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Generators/DungeonGrid.h"
+
+// The dungeon plane is split into square chunks addressed by integer coordinates.
+// Every room reached through an entrance is planned from (world seed, chunk, entrance cell, orientation) alone,
+// so the same entrance always opens onto the same corridor and room, in this session and the next.
+
+// Entrance a room is planned for, relative to the chunk it lies in
+struct FDungeonPlanKey {
+	// Entrance location in PlanCellSize steps from the chunk corner
+	FIntPoint Cell = FIntPoint::ZeroValue;
+	EDungeonOrientation Orientation = EDungeonOrientation::Forward;
+
+	bool operator==(const FDungeonPlanKey& Other) const { return Cell == Other.Cell and Orientation == Other.Orientation; }
+
+	friend uint32 GetTypeHash(const FDungeonPlanKey& Key) { return HashCombine(GetTypeHash(Key.Cell), static_cast<uint32>(Key.Orientation)); }
+
+	friend FArchive& operator<<(FArchive& Ar, FDungeonPlanKey& Key) {
+		uint8 Orientation = static_cast<uint8>(Key.Orientation);
+		Ar << Key.Cell << Orientation;
+		Key.Orientation = static_cast<EDungeonOrientation>(Orientation & 3);
+		return Ar;
+	}
+};
+
+// Everything random about a corridor and the room behind it, wall counts stay well below 256
+struct FDungeonRoomPlan {
+	uint8 CorridorWalls = 0;
+	uint8 ForwardWalls = 0;
+	uint8 RightWalls = 0;
+
+	// Wall the new room is entered through, on the side facing the corridor
+	uint8 EntranceIndex = 0;
+
+	int32 RoomSeed = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FDungeonRoomPlan& Plan) {
+		return Ar << Plan.CorridorWalls << Plan.ForwardWalls << Plan.RightWalls << Plan.EntranceIndex << Plan.RoomSeed;
+	}
+};
+
+struct FDungeonChunkLayout {
+	TMap<FDungeonPlanKey, FDungeonRoomPlan> Rooms;
+
+	friend FArchive& operator<<(FArchive& Ar, FDungeonChunkLayout& Layout) { return Ar << Layout.Rooms; }
+};
+
+// Planned chunk layouts of one world seed, persisted under Saved/DungeonCache
+class DUNGEONGENCORE_API FDungeonChunkCache {
+public:
+	// Granularity of entrance locations within a chunk
+	static constexpr float PlanCellSize = 50.f;
+
+	void Initialize(int32 InWorldSeed, float InChunkSize);
+
+	FIntPoint GetChunkCoord(const FVector& Location) const;
+
+	static int32 GetChunkSeed(int32 WorldSeed, FIntPoint Chunk);
+
+	// Plan of the room opened from an entrance, read from the cache or planned and cached
+	FDungeonRoomPlan FindOrPlanRoom(const FVector& EntranceLocation, EDungeonOrientation Orientation);
+
+	// Pure derivation of a plan, never touches the cache
+	static FDungeonRoomPlan PlanRoom(int32 ChunkSeed, const FDungeonPlanKey& Key);
+
+	// Read the file of the current seed and chunk size, returns false when there is none or it does not match
+	bool Load();
+
+	// Write the file when anything was planned since the last load or save
+	bool Save();
+
+	FString GetCacheFilename() const;
+
+	int32 GetChunkCount() const { return Chunks.Num(); }
+
+	int32 GetPlannedRoomCount() const;
+
+	int32 GetCacheHits() const { return CacheHits; }
+
+private:
+	int32 WorldSeed = 0;
+	float ChunkSize = 8000.f;
+
+	TMap<FIntPoint, FDungeonChunkLayout> Chunks;
+
+	bool bDirty = false;
+	int32 CacheHits = 0;
+};
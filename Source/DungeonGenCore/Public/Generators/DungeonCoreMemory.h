@@ -0,0 +1,7 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Low level memory tracker tag of the layout algorithms, the engine side tags live in DungeonMemory.h
+LLM_DECLARE_TAG_API(DungeonLayout, DUNGEONGENCORE_API); // Graph, shape cache, layout decisions
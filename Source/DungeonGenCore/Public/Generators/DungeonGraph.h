@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Stable identifier of a dungeon graph node, never reused while the graph lives
+typedef int32 FDungeonNodeId;
+
+enum class EDungeonNodeType : uint8 {
+	Room,
+	Corridor,
+	Entrance
+};
+
+struct FDungeonNode {
+	FDungeonNodeId Id = INDEX_NONE;
+	EDungeonNodeType Type = EDungeonNodeType::Room;
+
+	// Room tag for rooms, empty for the rest
+	FName Tag;
+
+	// Node that owns this one, e.g. the room of an entrance. Removing the owner removes it as well
+	FDungeonNodeId OwnerId = INDEX_NONE;
+};
+
+// Connectivity of rooms, corridors and entrances.
+// Edges are kept as a list and flattened into compact adjacency arrays (offsets + targets)
+// on the first query after a change, so topology queries never touch actors.
+// Not thread safe, queries reuse internal scratch buffers.
+class DUNGEONGENCORE_API FDungeonGraph {
+public:
+	FDungeonNodeId AddNode(EDungeonNodeType Type, FName Tag = NAME_None, FDungeonNodeId OwnerId = INDEX_NONE);
+
+	// Remove the node, its edges and every node it owns
+	void RemoveNode(FDungeonNodeId Id);
+
+	// Undirected edge, duplicates are ignored
+	void Connect(FDungeonNodeId A, FDungeonNodeId B);
+
+	const FDungeonNode* GetNode(FDungeonNodeId Id) const;
+
+	bool Contains(FDungeonNodeId Id) const { return IdToIndex.Contains(Id); }
+
+	int32 Num() const { return Nodes.Num(); }
+
+	// Node, edge and adjacency storage including the query scratch buffers
+	SIZE_T GetAllocatedSize() const;
+
+	void Reset();
+
+	// Number of edges between two nodes, INDEX_NONE when unreachable
+	int32 GetHopDistance(FDungeonNodeId From, FDungeonNodeId To) const;
+
+	// Closest room carrying Tag, INDEX_NONE when there is none
+	FDungeonNodeId FindNearestRoomWithTag(FDungeonNodeId From, FName Tag, int32* OutHops = nullptr) const;
+
+	// Shortest path including both ends, false when unreachable
+	bool FindPath(FDungeonNodeId From, FDungeonNodeId To, TArray<FDungeonNodeId>& OutPath) const;
+
+	// Visit every node within MaxHops of From in breadth-first order
+	void ForEachWithinHops(FDungeonNodeId From, int32 MaxHops, TFunctionRef<void(const FDungeonNode& Node, int32 Hops)> Visitor) const;
+
+	// Neighbour ids of a node
+	void GetNeighbours(FDungeonNodeId Id, TArray<FDungeonNodeId>& OutNeighbours) const;
+
+private:
+	// Breadth-first search from From, stops early once ShouldStop returns true for a visited node.
+	// Returns the dense index of the node it stopped at, INDEX_NONE otherwise. Fills Distances and Parents.
+	int32 Search(int32 FromIndex, int32 MaxHops, TFunctionRef<bool(int32 NodeIndex, int32 Hops)> ShouldStop) const;
+
+	void RebuildAdjacency() const;
+
+	TArray<FDungeonNode> Nodes;
+	TMap<FDungeonNodeId, int32> IdToIndex;
+
+	// Edges as pairs of node ids, the source of truth for the adjacency arrays
+	TArray<TPair<FDungeonNodeId, FDungeonNodeId>> Edges;
+
+	// Normalized edges packed into one key, so Connect spots duplicates with a hash probe instead of a scan
+	TSet<uint64> EdgeKeys;
+
+	static uint64 MakeEdgeKey(FDungeonNodeId A, FDungeonNodeId B) { return (static_cast<uint64>(static_cast<uint32>(A)) << 32) | static_cast<uint32>(B); }
+
+	FDungeonNodeId NextId = 0;
+
+	// Compressed adjacency: neighbours of node i are AdjacencyTargets[AdjacencyOffsets[i] .. AdjacencyOffsets[i + 1])
+	mutable TArray<int32> AdjacencyOffsets;
+	mutable TArray<int32> AdjacencyTargets;
+	mutable bool bAdjacencyDirty = true;
+
+	// Scratch buffers reused by every search
+	mutable TArray<int32> Distances;
+	mutable TArray<int32> Parents;
+	mutable TArray<int32> Frontier;
+};
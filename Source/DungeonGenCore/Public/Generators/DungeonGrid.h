@@ -0,0 +1,138 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Layout math of the generators. Positions live on an integer lattice measured in half walls
+// relative to the room origin, orientations are one of four values. Everything is resolved through
+// constexpr tables, world transforms are only produced at the very end by ToWorldLocation / ToWorldRotation.
+
+// The four directions a wall side, an entrance or a corridor can face
+enum class EDungeonOrientation : uint8 {
+	Forward = 0, // Yaw 0, +X
+	Right   = 1, // Yaw 90, +Y
+	Back    = 2, // Yaw 180, -X
+	Left    = 3  // Yaw -90, -Y
+};
+
+struct FDungeonGridStep {
+	int32 X;
+	int32 Y;
+};
+
+// Room anchor relative to an entrance, in half walls: X = XF * Forward + XE * Entrance + XC, Y = YR * Right + YE * Entrance + YC
+struct FDungeonAnchorCoefficients {
+	int32 XF, XE, XC;
+	int32 YR, YE, YC;
+};
+
+// Corridor shape for an entrance orientation. The random length goes to ForwardWalls or RightWalls,
+// the start offset in half walls is X = XN * Length + XC, Y = YN * Length + YC
+struct FDungeonCorridorCoefficients {
+	bool bLengthAlongForward;
+	int32 XN, XC;
+	int32 YN, YC;
+};
+
+namespace DungeonGrid {
+	constexpr float YawTable[4] = { 0.f, 90.f, 180.f, -90.f };
+
+	constexpr EDungeonOrientation OppositeTable[4] = { EDungeonOrientation::Back, EDungeonOrientation::Left, EDungeonOrientation::Forward, EDungeonOrientation::Right };
+
+	// Unit step along a side
+	constexpr FDungeonGridStep DirectionTable[4] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+
+	// Jump from the end of the previous side to the start of this one, in half walls
+	constexpr FDungeonGridStep CornerTable[4] = { { 0, 0 }, { -1, 1 }, { -1, -1 }, { 1, -1 } };
+
+	// Where a new room is anchored relative to its entrance, indexed by the new entrance orientation
+	constexpr FDungeonAnchorCoefficients AnchorTable[4] = {
+		{ 2, -2, -2,  0,  0,  0 },
+		{ 2,  0, -1,  0,  2,  1 },
+		{ 2, -2, -2,  2,  0,  0 },
+		{ 0,  0, -1,  2, -2, -1 }
+	};
+
+	// Corridor parameters, indexed by the orientation of the entrance it leaves from
+	constexpr FDungeonCorridorCoefficients CorridorTable[4] = {
+		{ false, 0,  0, 2, 0 },
+		{ true,  0, -1, 0, 1 },
+		{ false, 0,  0, 0, 0 },
+		{ true,  2, -1, 0, 1 }
+	};
+
+	constexpr int32 Index(EDungeonOrientation Orientation) { return static_cast<int32>(Orientation); }
+
+	constexpr float ToYaw(EDungeonOrientation Orientation) { return YawTable[Index(Orientation)]; }
+
+	constexpr EDungeonOrientation Opposite(EDungeonOrientation Orientation) { return OppositeTable[Index(Orientation)]; }
+
+	// Sides facing Forward / Back run along the forward dimension of a room
+	constexpr bool IsForwardAxis(EDungeonOrientation Orientation) { return (Index(Orientation) & 1) == 0; }
+
+	constexpr int32 WallsOnSide(EDungeonOrientation Side, int32 ForwardWalls, int32 RightWalls) { return IsForwardAxis(Side) ? ForwardWalls : RightWalls; }
+
+	// Nearest orientation of any yaw, -180 and 270 included
+	inline EDungeonOrientation FromYaw(float Yaw) {
+		return static_cast<EDungeonOrientation>(FMath::RoundToInt(Yaw / 90.f) & 3);
+	}
+
+	// Same as FromYaw, but fails when the yaw is not within Tolerance degrees of a quarter turn
+	inline bool TryFromYaw(float Yaw, EDungeonOrientation& OutOrientation, float Tolerance = 1.f) {
+		const float Quarters = Yaw / 90.f;
+		if (!FMath::IsNearlyEqual(Quarters, static_cast<float>(FMath::RoundToInt(Quarters)), Tolerance / 90.f)) {
+			return false;
+		}
+		OutOrientation = FromYaw(Yaw);
+		return true;
+	}
+
+	// Lattice point where the walls of a side start
+	inline FIntPoint GetSideStart(EDungeonOrientation Side, int32 ForwardWalls, int32 RightWalls) {
+		FIntPoint Point(0, 0);
+		for (int32 Previous = 0; Previous < Index(Side); Previous++) {
+			const int32 Walls = WallsOnSide(static_cast<EDungeonOrientation>(Previous), ForwardWalls, RightWalls);
+			Point.X += DirectionTable[Previous].X * 2 * Walls + CornerTable[Previous + 1].X;
+			Point.Y += DirectionTable[Previous].Y * 2 * Walls + CornerTable[Previous + 1].Y;
+		}
+		return Point;
+	}
+
+	// Lattice point of the wall at WallIndex along a side
+	inline FIntPoint GetWallPoint(EDungeonOrientation Side, FIntPoint SideStart, int32 WallIndex) {
+		return FIntPoint(SideStart.X + DirectionTable[Index(Side)].X * 2 * WallIndex, SideStart.Y + DirectionTable[Index(Side)].Y * 2 * WallIndex);
+	}
+
+	inline FIntPoint GetAnchor(EDungeonOrientation EntranceOrientation, int32 ForwardWalls, int32 RightWalls, int32 EntranceIndex) {
+		const FDungeonAnchorCoefficients& C = AnchorTable[Index(EntranceOrientation)];
+		return FIntPoint(C.XF * ForwardWalls + C.XE * EntranceIndex + C.XC, C.YR * RightWalls + C.YE * EntranceIndex + C.YC);
+	}
+
+	inline FIntPoint GetCorridorOffset(EDungeonOrientation EntranceOrientation, int32 Length) {
+		const FDungeonCorridorCoefficients& C = CorridorTable[Index(EntranceOrientation)];
+		return FIntPoint(C.XN * Length + C.XC, C.YN * Length + C.YC);
+	}
+
+	inline FVector ToWorldOffset(FIntPoint Point, float WallLength) {
+		return FVector(Point.X, Point.Y, 0.f) * (WallLength / 2);
+	}
+
+	inline FVector ToWorldLocation(const FVector& Origin, const FRotator& OriginRotation, FIntPoint Point, float WallLength) {
+		return Origin + OriginRotation.RotateVector(ToWorldOffset(Point, WallLength));
+	}
+
+	inline FRotator ToWorldRotation(const FRotator& OriginRotation, EDungeonOrientation Orientation) {
+		return OriginRotation + FRotator(0.f, ToYaw(Orientation), 0.f);
+	}
+
+	// Inverse of ToWorldLocation, snapped to the nearest lattice point
+	inline FIntPoint ToLatticePoint(const FVector& Origin, const FRotator& OriginRotation, const FVector& WorldLocation, float WallLength) {
+		const FVector Local = OriginRotation.UnrotateVector(WorldLocation - Origin) / (WallLength / 2);
+		return FIntPoint(FMath::RoundToInt(Local.X), FMath::RoundToInt(Local.Y));
+	}
+
+	// Inverse of GetWallPoint
+	inline int32 GetWallIndex(EDungeonOrientation Side, FIntPoint SideStart, FIntPoint Point) {
+		const FDungeonGridStep& Step = DirectionTable[Index(Side)];
+		return ((Point.X - SideStart.X) * Step.X + (Point.Y - SideStart.Y) * Step.Y) / 2;
+	}
+}
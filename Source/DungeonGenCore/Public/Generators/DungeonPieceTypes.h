@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Category of a generated piece, mirrors the lists kept by FRoomStruct
+enum class ERoomPieceCategory : uint8 {
+	Wall,
+	Entrance,
+	Floor,
+	Roof,
+	Prop
+};
+
+// Category and state bits of a piece, one byte per piece in FRoomPieceTable
+enum class ERoomPieceFlags : uint8 {
+	None     = 0,
+	Wall     = 1 << 0,
+	Entrance = 1 << 1,
+	Floor    = 1 << 2,
+	Roof     = 1 << 3,
+	Prop     = 1 << 4,
+
+	// Piece only exists in the full detail tier
+	Detail   = 1 << 5,
+
+	// Lower wall position that takes the lighted wall variant in the full detail tier
+	LightSlot = 1 << 6,
+
+	Hidden   = 1 << 7,
+
+	AllCategories = Wall | Entrance | Floor | Roof | Prop
+};
+ENUM_CLASS_FLAGS(ERoomPieceFlags)
+
+inline ERoomPieceFlags ToPieceFlag(ERoomPieceCategory Category) {
+	return static_cast<ERoomPieceFlags>(1 << static_cast<uint8>(Category));
+}
+
+// Category of a piece from its flags, the lowest category bit wins
+inline ERoomPieceCategory ToPieceCategory(ERoomPieceFlags PieceFlags) {
+	return static_cast<ERoomPieceCategory>(FMath::CountTrailingZeros(static_cast<uint32>(PieceFlags & ERoomPieceFlags::AllCategories)));
+}
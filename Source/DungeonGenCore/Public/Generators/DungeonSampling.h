@@ -0,0 +1,10 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Random choices of the generators, kept apart from the actors so they can be checked against a fixed seed
+namespace DungeonSampling {
+	// Index drawn with a probability proportional to its weight, INDEX_NONE when no weight is positive.
+	// Draws exactly one value from the stream either way
+	DUNGEONGENCORE_API int32 PickWeighted(FRandomStream& Stream, TArrayView<const float> Weights);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Generators/DungeonGrid.h"
+#include "Generators/DungeonPieceTypes.h"
+
+// Dimensions of a room and the entrance it was entered through. The entrances rolled for the other sides are
+// cut in at spawn time through FRoomShapeEntrances, so the key space stays at dimensions times incoming walls,
+// a few thousand keys at most for the 3 to 11 wall range
+struct FRoomShapeKey {
+	int32 ForwardWalls = 0;
+	int32 RightWalls = 0;
+
+	// Side and wall index of the incoming entrance, INDEX_NONE for a room without one
+	int32 EntranceSide = INDEX_NONE;
+	int32 EntranceIndex = INDEX_NONE;
+
+	bool operator==(const FRoomShapeKey& Other) const {
+		return ForwardWalls == Other.ForwardWalls and RightWalls == Other.RightWalls and EntranceSide == Other.EntranceSide and EntranceIndex == Other.EntranceIndex;
+	}
+
+	friend uint32 GetTypeHash(const FRoomShapeKey& Key) {
+		return HashCombine(HashCombine(GetTypeHash(Key.ForwardWalls), GetTypeHash(Key.RightWalls)), HashCombine(GetTypeHash(Key.EntranceSide), GetTypeHash(Key.EntranceIndex)));
+	}
+};
+
+// Wall or entrance slot of a room in local space
+struct FRoomShapePiece {
+	// Lattice point in half walls relative to the room origin
+	FIntPoint Cell = FIntPoint::ZeroValue;
+	EDungeonOrientation Side = EDungeonOrientation::Forward;
+	int32 WallIndex = 0;
+	ERoomPieceCategory Category = ERoomPieceCategory::Wall;
+
+	// LightSlot for walls that take the lighted variant
+	ERoomPieceFlags Flags = ERoomPieceFlags::None;
+};
+
+// Entrances opened on top of a template, one wall index per side, INDEX_NONE for a side the template decides
+struct FRoomShapeEntrances {
+	int32 Indices[4] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+
+	bool IsEntrance(const FRoomShapePiece& Piece) const {
+		return Piece.Category == ERoomPieceCategory::Entrance or Piece.WallIndex == Indices[DungeonGrid::Index(Piece.Side)];
+	}
+};
+
+// Immutable wall layout of one shape key, shared by every room using it
+struct FRoomShapeTemplate {
+	FRoomShapeKey Key;
+	TArray<FRoomShapePiece> Pieces;
+};
+
+// Process-wide memo of room shape templates.
+// Templates never change once built, so readers keep the shared reference and never hold the lock.
+class DUNGEONGENCORE_API FRoomShapeCache {
+public:
+	static FRoomShapeCache& Get();
+
+	// Cached template of the key, built on first use. Safe to call from any thread
+	TSharedRef<const FRoomShapeTemplate> FindOrBuild(const FRoomShapeKey& Key);
+
+	// Compute a template without touching the cache
+	static TSharedRef<const FRoomShapeTemplate> Build(const FRoomShapeKey& Key);
+
+	int32 Num() const;
+
+	// Templates and the map holding them
+	SIZE_T GetAllocatedSize() const;
+
+	void Reset();
+
+private:
+	mutable FRWLock Lock;
+	TMap<FRoomShapeKey, TSharedRef<const FRoomShapeTemplate>> Templates;
+};
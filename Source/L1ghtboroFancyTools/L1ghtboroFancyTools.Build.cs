@@ -8,7 +8,7 @@ public class L1ghtboroFancyTools : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "UMG", "Json", "JsonUtilities", "Engine", "InputCore" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "UMG", "Json", "JsonUtilities", "Engine", "InputCore", "DungeonGenCore" });
 
 		PrivateDependencyModuleNames.AddRange(new string[] {  });
 
@@ -0,0 +1,74 @@
+#include "Generators/DungeonCollision.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Actor.h"
+
+namespace {
+	UBoxComponent* AddBox(AActor* Owner, const FVector& Center, const FRotator& Rotation, const FVector& Extent) {
+		UBoxComponent* Box = NewObject<UBoxComponent>(Owner);
+		Box->SetupAttachment(Owner->GetRootComponent());
+		Box->SetBoxExtent(Extent, false);
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Box->RegisterComponent();
+		Box->SetWorldLocationAndRotation(Center, Rotation);
+		return Box;
+	}
+}
+
+UBoxComponent* DungeonCollision::AddWallBox(AActor* Owner, const FVector& WallLocation, const FRotator& WallRotation, float WallLength, float WallHeight) {
+	const FVector Extent(WallLength / 2, WallThickness / 2, WallHeight / 2);
+	return AddBox(Owner, WallLocation + FVector(0.f, 0.f, WallHeight / 2), WallRotation, Extent);
+}
+
+UBoxComponent* DungeonCollision::AddFloorBox(AActor* Owner, const FVector& StartLocation, const FRotator& StartRotation, int32 ForwardWalls, int32 RightWalls, float WallLength) {
+	const FVector Center = StartLocation + FVector(ForwardWalls * WallLength / 2 - WallLength / 2, RightWalls * WallLength / 2, -20.f);
+	const FVector Extent(ForwardWalls * WallLength / 2, RightWalls * WallLength / 2, FloorThickness / 2);
+	return AddBox(Owner, Center, StartRotation, Extent);
+}
+
+AActor* DungeonCollision::SpawnPiece(UWorld* World, UClass* Class, const FTransform& Transform, bool bEnableCollision) {
+	if (!World or !Class) {
+		return nullptr;
+	}
+	if (bEnableCollision) {
+		return World->SpawnActor<AActor>(Class, Transform);
+	}
+
+	AActor* Piece = World->SpawnActorDeferred<AActor>(Class, Transform);
+	if (Piece) {
+		Piece->SetActorEnableCollision(false);
+		Piece->FinishSpawning(Transform);
+	}
+	return Piece;
+}
+
+AActor* DungeonCollision::SpawnEntranceVolume(UWorld* World, const FVector& Location, const FRotator& Rotation, float WallLength, float WallHeight) {
+	AActor* Volume = World->SpawnActor<AActor>(AActor::StaticClass(), Location, Rotation);
+	if (!Volume) {
+		return nullptr;
+	}
+
+	// Root stays at the pivot, the trigger sits on top of it
+	USceneComponent* Root = NewObject<USceneComponent>(Volume, TEXT("EntranceRoot"));
+	Volume->SetRootComponent(Root);
+	Root->RegisterComponent();
+
+	UBoxComponent* Trigger = NewObject<UBoxComponent>(Volume, TEXT("EntranceVolume"));
+	Trigger->SetupAttachment(Root);
+	Trigger->SetRelativeLocation(FVector(0.f, 0.f, WallHeight / 2));
+	Trigger->SetBoxExtent(FVector(WallLength / 2, WallThickness, WallHeight / 2), false);
+	Trigger->SetCollisionProfileName(TEXT("Trigger"));
+	Trigger->RegisterComponent();
+
+	Volume->SetActorLocationAndRotation(Location, Rotation);
+	return Volume;
+}
+
+void DungeonCollision::DestroyBoxes(TArray<UBoxComponent*>& Boxes) {
+	for (UBoxComponent* Box : Boxes) {
+		if (IsValid(Box)) {
+			Box->DestroyComponent();
+		}
+	}
+	Boxes.Empty();
+}
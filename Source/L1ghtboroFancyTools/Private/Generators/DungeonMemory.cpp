@@ -0,0 +1,25 @@
+#include "Generators/DungeonMemory.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+
+LLM_DEFINE_TAG(DungeonPieces);
+LLM_DEFINE_TAG(DungeonAssets);
+LLM_DEFINE_TAG(DungeonConfig);
+
+void DungeonMemory::AccumulateActor(const AActor* Actor, FDungeonMemoryStats& Stats) {
+	if (!IsValid(Actor)) {
+		return;
+	}
+
+	Stats.ObjectBytes += Actor->GetClass()->GetStructureSize();
+	for (const UActorComponent* Component : Actor->GetComponents()) {
+		if (Component) {
+			Stats.ObjectBytes += Component->GetClass()->GetStructureSize();
+			Stats.Components++;
+		}
+	}
+}
+
+FString DungeonMemory::FormatBytes(SIZE_T Bytes) {
+	return FString::Printf(TEXT("%.1f KiB"), Bytes / 1024.0);
+}
@@ -0,0 +1,63 @@
+#include "Generators/PieceDestructionQueue.h"
+
+DEFINE_LOG_CATEGORY(LogPieceDestruction);
+
+void FPieceDestructionQueue::Enqueue(AActor* Actor) {
+	if (!IsValid(Actor)) {
+		return;
+	}
+
+	// Visual change is instant, the actual destruction happens in a later batch
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	PendingActors.Add(Actor);
+}
+
+int32 FPieceDestructionQueue::ProcessBatch(float BudgetSeconds, int32 MaxPieces) {
+	check(IsInGameThread());
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 Destroyed = 0;
+
+	while (Head < PendingActors.Num() and Destroyed < MaxPieces) {
+		AActor* Actor = PendingActors[Head++].Get();
+		if (IsValid(Actor)) {
+			Actor->Destroy();
+			Destroyed++;
+		}
+
+		// Checking the clock every few pieces is enough, a single Destroy is cheap compared to the budget
+		if (Destroyed % 8 == 0 and FPlatformTime::Seconds() - StartTime >= BudgetSeconds) {
+			break;
+		}
+	}
+
+	Compact();
+
+	if (Destroyed > 0) {
+		UE_LOG(LogPieceDestruction, Verbose, TEXT("Destroyed %d pieces, %d still queued"), Destroyed, Num());
+	}
+	return Destroyed;
+}
+
+void FPieceDestructionQueue::Flush() {
+	const int32 Remaining = Num();
+	ProcessBatch(TNumericLimits<float>::Max(), TNumericLimits<int32>::Max());
+	UE_LOG(LogPieceDestruction, Log, TEXT("Flushed %d queued pieces"), Remaining);
+}
+
+void FPieceDestructionQueue::Compact() {
+	if (Head == PendingActors.Num()) {
+		PendingActors.Reset();
+		Head = 0;
+		return;
+	}
+
+	// Drop the consumed prefix only once it dominates the array, so the shift is amortized
+	if (Head > 256 and Head * 2 > PendingActors.Num()) {
+		PendingActors.RemoveAt(0, Head, false);
+		Head = 0;
+	}
+}
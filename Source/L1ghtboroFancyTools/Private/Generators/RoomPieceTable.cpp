@@ -0,0 +1,171 @@
+#include "Generators/RoomPieceTable.h"
+#include "Generators/PieceDestructionQueue.h"
+#include "GameFramework/Actor.h"
+#include "UObject/UObjectGlobals.h"
+
+int32 FRoomPieceTable::AddActor(AActor* Actor, UClass* Class, const FTransform& Transform, ERoomPieceCategory Category, ERoomPieceFlags ExtraFlags) {
+	FRoomPieceHandle Handle;
+	Handle.Actor = Actor;
+	Handle.Kind = ERoomPieceHandleKind::Actor;
+	return Add(Handle, Class, Transform, ToPieceFlag(Category) | ExtraFlags);
+}
+
+int32 FRoomPieceTable::AddSlot(int32 Slot, ERoomPieceHandleKind Kind, UClass* Class, const FTransform& Transform, ERoomPieceCategory Category, ERoomPieceFlags ExtraFlags) {
+	FRoomPieceHandle Handle;
+	Handle.Slot = Slot;
+	Handle.Kind = Kind;
+	return Add(Handle, Class, Transform, ToPieceFlag(Category) | ExtraFlags);
+}
+
+int32 FRoomPieceTable::Add(const FRoomPieceHandle& Handle, UClass* Class, const FTransform& Transform, ERoomPieceFlags PieceFlags) {
+	Transforms.Add(Transform);
+	ClassIndices.Add(GetClassIndex(Class));
+	Flags.Add(PieceFlags);
+	return Handles.Add(Handle);
+}
+
+uint16 FRoomPieceTable::GetClassIndex(UClass* Class) {
+	int32 Index = ClassPalette.Find(Class);
+	if (Index == INDEX_NONE) {
+		Index = ClassPalette.Add(Class);
+	}
+	check(Index <= MAX_uint16);
+	return static_cast<uint16>(Index);
+}
+
+int32 FRoomPieceTable::Count(ERoomPieceFlags CategoryMask) const {
+	int32 Result = 0;
+	for (ERoomPieceFlags PieceFlags : Flags) {
+		Result += EnumHasAnyFlags(PieceFlags, CategoryMask) ? 1 : 0;
+	}
+	return Result;
+}
+
+FBox FRoomPieceTable::ComputeBounds(ERoomPieceFlags CategoryMask, const FVector& PieceExtent) const {
+	FBox Bounds(ForceInit);
+	for (int32 Index = 0; Index < Flags.Num(); Index++) {
+		if (EnumHasAnyFlags(Flags[Index], CategoryMask)) {
+			Bounds += Transforms[Index].GetLocation();
+		}
+	}
+	return Bounds.IsValid ? Bounds.ExpandBy(PieceExtent) : Bounds;
+}
+
+int32 FRoomPieceTable::SetHidden(ERoomPieceFlags CategoryMask, bool bHidden) {
+	int32 Touched = 0;
+	for (int32 Index = 0; Index < Flags.Num(); Index++) {
+		ERoomPieceFlags& PieceFlags = Flags[Index];
+
+		// Skip pieces of other categories and pieces already in the requested state without touching the actor
+		if (!EnumHasAnyFlags(PieceFlags, CategoryMask) or EnumHasAnyFlags(PieceFlags, ERoomPieceFlags::Hidden) == bHidden) {
+			continue;
+		}
+
+		if (bHidden) {
+			PieceFlags |= ERoomPieceFlags::Hidden;
+		}
+		else {
+			PieceFlags &= ~ERoomPieceFlags::Hidden;
+		}
+
+		AActor* Actor = Handles[Index].Actor;
+		if (Handles[Index].Kind == ERoomPieceHandleKind::Actor and IsValid(Actor)) {
+			Actor->SetActorHiddenInGame(bHidden);
+			Touched++;
+		}
+	}
+	return Touched;
+}
+
+int32 FRoomPieceTable::SetCollisionEnabled(bool bEnabled, int32& Cursor, int32 MaxPieces) {
+	int32 Touched = 0;
+	while (Cursor < Handles.Num() and Touched < MaxPieces) {
+		AActor* Actor = Handles[Cursor++].Actor;
+		if (IsValid(Actor) and Actor->GetActorEnableCollision() != bEnabled) {
+			Actor->SetActorEnableCollision(bEnabled);
+			Touched++;
+		}
+	}
+	return Touched;
+}
+
+int32 FRoomPieceTable::DestroyPieces(ERoomPieceFlags CategoryMask, FPieceDestructionQueue* Queue) {
+	return DestroyPiecesWhere([this, CategoryMask](int32 PieceIndex) { return EnumHasAnyFlags(Flags[PieceIndex], CategoryMask); }, Queue);
+}
+
+int32 FRoomPieceTable::DestroyPiecesWhere(TFunctionRef<bool(int32 PieceIndex)> Predicate, FPieceDestructionQueue* Queue, TArray<AActor*>* OutRemovedActors) {
+	int32 Removed = 0;
+	int32 Kept = 0;
+
+	// Single stable compaction pass over all arrays, the predicate always sees original indices
+	for (int32 Index = 0; Index < Flags.Num(); Index++) {
+		if (Predicate(Index)) {
+			AActor* Actor = Handles[Index].Actor;
+			if (Handles[Index].Kind == ERoomPieceHandleKind::Actor and IsValid(Actor)) {
+				if (OutRemovedActors) {
+					OutRemovedActors->Add(Actor);
+				}
+				if (Queue) {
+					Queue->Enqueue(Actor);
+				}
+				else {
+					Actor->Destroy();
+				}
+			}
+			Removed++;
+			continue;
+		}
+
+		if (Kept != Index) {
+			Transforms[Kept] = Transforms[Index];
+			ClassIndices[Kept] = ClassIndices[Index];
+			Flags[Kept] = Flags[Index];
+			Handles[Kept] = Handles[Index];
+		}
+		Kept++;
+	}
+
+	Transforms.SetNum(Kept, false);
+	ClassIndices.SetNum(Kept, false);
+	Flags.SetNum(Kept, false);
+	Handles.SetNum(Kept, false);
+
+	return Removed;
+}
+
+bool FRoomPieceTable::MovePiece(int32 PieceIndex, const FTransform& Transform, ERoomPieceFlags StateFlags) {
+	const ERoomPieceFlags KeptFlags = ERoomPieceFlags::AllCategories | ERoomPieceFlags::Hidden;
+	Flags[PieceIndex] = (Flags[PieceIndex] & KeptFlags) | (StateFlags & ~KeptFlags);
+
+	if (Transforms[PieceIndex].Equals(Transform)) {
+		return false;
+	}
+	Transforms[PieceIndex] = Transform;
+
+	AActor* Actor = Handles[PieceIndex].Actor;
+	if (Handles[PieceIndex].Kind == ERoomPieceHandleKind::Actor and IsValid(Actor)) {
+		Actor->SetActorTransform(Transform);
+	}
+	return true;
+}
+
+void FRoomPieceTable::AddReferencedObjects(FReferenceCollector& Collector) {
+	for (FRoomPieceHandle& Handle : Handles) {
+		if (Handle.Kind == ERoomPieceHandleKind::Actor) {
+			Collector.AddReferencedObject(Handle.Actor);
+		}
+	}
+	Collector.AddReferencedObjects(ClassPalette);
+}
+
+SIZE_T FRoomPieceTable::GetAllocatedSize() const {
+	return Transforms.GetAllocatedSize() + ClassIndices.GetAllocatedSize() + Flags.GetAllocatedSize() + Handles.GetAllocatedSize() + ClassPalette.GetAllocatedSize();
+}
+
+void FRoomPieceTable::Reset() {
+	Transforms.Reset();
+	ClassIndices.Reset();
+	Flags.Reset();
+	Handles.Reset();
+	ClassPalette.Reset();
+}
@@ -1,4 +1,9 @@
 #include "Generators/SpawnCorridor.h"
+#include "Generators/PieceDestructionQueue.h"
+#include "Generators/SpawnDungeon.h"
+#include "Generators/DungeonCollision.h"
+#include "Generators/DungeonMemory.h"
+#include "Components/BoxComponent.h"
 #include "Utilities/LoggingTool.h"
 
 // Define log category for SpawnCorridor
@@ -15,10 +20,14 @@ ASpawnCorridor::ASpawnCorridor(){
 	SetParamWallLength(400.f);
 
 	CorridroTag = "Corridor";
+
+	bCollisionOnly = false;
 }
 
 // Init Assets to build room
 void ASpawnCorridor::InitAssets() {
+	LLM_SCOPE_BYTAG(DungeonAssets);
+
 	// Lambda function to load asset classes based on the asset name
 	auto LoadAssetClass = [this](const FString& AssetName) -> TSubclassOf<AActor> {
 		FString Directory;
@@ -66,6 +75,9 @@ void ASpawnCorridor::InitAssets() {
 void ASpawnCorridor::BeginPlay(){
 	Super::BeginPlay();
 	ULoggingTool::LogDebugMessage(TEXT("Corridor BeginPlay called."));
+
+	// Dedicated servers only need collision, the dungeon may still override this before CreateCorridor
+	bCollisionOnly = GetNetMode() == NM_DedicatedServer;
 }
 
 // Tick is called every frame
@@ -73,11 +85,6 @@ void ASpawnCorridor::Tick(float DeltaTime){
 	Super::Tick(DeltaTime);
 }
 
-// Calculate a new position based on a positioning vector, a direction vector, and lengths
-FVector ASpawnCorridor::DotProduct(FVector PositioningVector, FVector SymbolVector, float WallLength = 0.f, float WallHeight = 0.f) {
-	return FVector(PositioningVector.X += WallLength * SymbolVector.X, PositioningVector.Y += WallLength * SymbolVector.Y, PositioningVector.Z += WallHeight * SymbolVector.Z);
-}
-
 // Create a floor actor and add it to the corridor
 void ASpawnCorridor::CreateFloor(TSubclassOf<AActor> FloorClass, FVector StartLocation, FRotator StartRotation, int32 FloorWidth, int32 FloorLength, float WallLength) {
 	UWorld* World = GetWorld();
@@ -85,6 +92,11 @@ void ASpawnCorridor::CreateFloor(TSubclassOf<AActor> FloorClass, FVector StartLo
 		return;
 	}
 
+	if (bCollisionOnly) {
+		AddCollisionPiece(DungeonCollision::AddFloorBox(this, StartLocation, StartRotation, FloorWidth, FloorLength, WallLength), ERoomPieceCategory::Floor);
+		return;
+	}
+
 	// Calculate spawn location
 	AActor* SpawnedFloor = World->SpawnActor<AActor>(FloorClass, FVector(FloorWidth * WallLength / 2 - WallLength / 2, FloorLength * WallLength / 2, -20.f) + StartLocation, StartRotation);
 	if (!SpawnedFloor) {
@@ -97,6 +109,7 @@ void ASpawnCorridor::CreateFloor(TSubclassOf<AActor> FloorClass, FVector StartLo
 	
 	// Add to floor object list
 	CorridorObjects.FloorObjectAdd(SpawnedFloor);
+	PieceTable.AddActor(SpawnedFloor, FloorClass, SpawnedFloor->GetActorTransform(), ERoomPieceCategory::Floor);
 }
 
 // Create a roof actor and add it to the corridor
@@ -116,8 +129,9 @@ void ASpawnCorridor::CreateRoof(TSubclassOf<AActor> RoofClass, FVector StartLoca
 	SpawnedRoof->SetActorScale3D(FVector(static_cast<float>(RoofWidth), static_cast<float>(RoofLength), 1.f));
 	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Corridor Roof created at location: %s"), *SpawnedRoof->GetActorLocation().ToString()));
 
-	// Add to floor object list
+	// Add to roof object list
 	CorridorObjects.RoofObjectAdd(SpawnedRoof);
+	PieceTable.AddActor(SpawnedRoof, RoofClass, SpawnedRoof->GetActorTransform(), ERoomPieceCategory::Roof);
 }
 
 // Create walls around the corridor
@@ -127,49 +141,59 @@ void ASpawnCorridor::CreateWall(TSubclassOf<AActor> WallClass, TSubclassOf<AActo
 		return;
 	}
 
-	// Define vectors for wall placement
-	FVector DotProductVector[] = { FVector(1.f, 1.f, 0.f), FVector(-0.5f, 0.5f, 0.f), FVector(-0.5f, -0.5f, 0.f), FVector(0.5f, -0.5f, 0.f) };
-	for (int32 i = 0; i < 4; i++) {
-		StartLocation = CreateWallSegment(WallClass, WallClassLighted, DotProduct(StartLocation, DotProductVector[i], i == 0 ? 0.f : WallLength), StartRotation + FRotator(0.f, 90.f * i, 0.f), i % 2 == 0 ? NumberOfWallsForward : NumberOfWallsRight, WallLength, GapBetweenWalls);
-		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Wall segment created at location: %s"), *StartLocation.ToString()));
-	}
-}
+	// One lattice step is half a wall plus half a gap
+	const float GridUnit = WallLength + GapBetweenWalls;
 
-// Create segments of a wall in a direction
-FVector ASpawnCorridor::CreateWallSegment(TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLighted, FVector StartLocation, FRotator StartRotation, int32 NumberOfWalls, float WallLength, float GapBetweenWalls) {
-	UWorld* World = GetWorld();
-	if (!World) {
-		return FVector::ZeroVector;
+	for (int32 SideIndex = 0; SideIndex < 4; SideIndex++) {
+		const EDungeonOrientation Side = static_cast<EDungeonOrientation>(SideIndex);
+		GenerateWalls(World, WallClass, WallClassLighted, StartLocation, StartRotation, Side, NumberOfWallsForward, NumberOfWallsRight, GridUnit);
+		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Wall segment created at location: %s"), *DungeonGrid::ToWorldLocation(StartLocation, StartRotation, DungeonGrid::GetSideStart(Side, NumberOfWallsForward, NumberOfWallsRight), GridUnit).ToString()));
 	}
-
-	return GenerateWalls(World, WallClass, StartLocation, StartRotation, NumberOfWalls, WallLength, GapBetweenWalls, WallClassLighted);
 }
 
-FVector ASpawnCorridor::GenerateWalls(UWorld* World, TSubclassOf<AActor> WallClass, FVector StartLocation, FRotator StartRotation, int32 NumberOfWalls, float WallLength, float GapBetweenWalls, TSubclassOf<AActor> WallClassLighted) {
+// Spawn the walls of one side of the corridor
+void ASpawnCorridor::GenerateWalls(UWorld* World, TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLighted, FVector Origin, FRotator OriginRotation, EDungeonOrientation Side, int32 NumberOfWallsForward, int32 NumberOfWallsRight, float GridUnit) {
+	// Single wall sides are the open ends of the corridor
+	const int32 NumberOfWalls = DungeonGrid::WallsOnSide(Side, NumberOfWallsForward, NumberOfWallsRight);
 	if (NumberOfWalls == 1) {
-		FVector Direction = abs(StartRotation.Roll) == 180 or abs(StartRotation.Roll) == 0 ? StartRotation.Vector() : FRotationMatrix(StartRotation).GetScaledAxis(EAxis::X);
-		
-		return StartLocation += (WallLength + GapBetweenWalls) * Direction;
+		return;
 	}
-	
+
+	const FIntPoint SideStart = DungeonGrid::GetSideStart(Side, NumberOfWallsForward, NumberOfWallsRight);
+	const FRotator WallRotation = DungeonGrid::ToWorldRotation(OriginRotation, Side);
+
 	for (int32 WallIndex = 0; WallIndex < NumberOfWalls; WallIndex++) {
 		UClass* ClasstoSpawn = WallIndex % 3 == 0 and WallClassLighted != nullptr ? WallClassLighted : WallClass;
 
-		AActor* SpawnedWall = World->SpawnActor<AActor>(ClasstoSpawn, StartLocation, StartRotation);
-
-		CorridorObjects.FloorObjectAdd(SpawnedWall);
+		const FVector WallLocation = DungeonGrid::ToWorldLocation(Origin, OriginRotation, DungeonGrid::GetWallPoint(Side, SideStart, WallIndex), GridUnit);
 
-		// Determine direction of wall segment
-		FVector Direction = abs(StartRotation.Roll) == 180 or abs(StartRotation.Roll / WallIndex) == 0 ? StartRotation.Vector() : FRotationMatrix(StartRotation).GetScaledAxis(EAxis::X);
+		// Server profile: full height wall boxes instead of blueprints
+		if (bCollisionOnly) {
+			AddCollisionPiece(DungeonCollision::AddWallBox(this, WallLocation, WallRotation, GridUnit, CollisionShellHeight), ERoomPieceCategory::Wall);
+			continue;
+		}
+		AActor* SpawnedWall = World->SpawnActor<AActor>(ClasstoSpawn, WallLocation, WallRotation);
 
-		StartLocation += (WallLength + GapBetweenWalls) * Direction;
+		if (SpawnedWall) {
+			CorridorObjects.WallObjectAdd(SpawnedWall);
+			PieceTable.AddActor(SpawnedWall, ClasstoSpawn, SpawnedWall->GetActorTransform(), ERoomPieceCategory::Wall);
+		}
 	}
-	return StartLocation;
 }
 
 // Create the entire corridor including floor, walls, and roof
 void ASpawnCorridor::CreateCorridor() {
+	LLM_SCOPE_BYTAG(DungeonPieces);
 	ULoggingTool::LogDebugMessage(TEXT("Creating corridor..."));
+
+	// Server profile: floor and wall collision only, corridor assets are never loaded
+	if (bCollisionOnly) {
+		CreateFloor(nullptr, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
+		CreateWall(nullptr, nullptr, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, 0.f);
+		ULoggingTool::LogDebugMessage(TEXT("Corridor collision created successfully."), FColor::Green);
+		return;
+	}
+
 	AssignCorridorAssets("JSON/RoomAssets.json");
 	InitAssets();
 	CreateFloor(DefaultFloorClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
@@ -178,38 +202,61 @@ void ASpawnCorridor::CreateCorridor() {
 	ULoggingTool::LogDebugMessage(TEXT("Corridor created successfully."), FColor::Green);
 }
 
+// Queue of the owning dungeon, nullptr once the dungeon is gone
+FPieceDestructionQueue* ASpawnCorridor::GetDestructionQueue() const {
+	ASpawnDungeon* Dungeon = OwningDungeon.Get();
+	return Dungeon ? &Dungeon->GetDestructionQueue() : nullptr;
+}
+
 // Destroy all corridor objects
 void ASpawnCorridor::DestroyCorridor(){
-	// Creating lambda function to destory actors
-	auto SafeDestroyActor = [](AActor* Actor) {
-		if (Actor) {
-			AsyncTask(ENamedThreads::GameThread, [Actor]() {
-				if (Actor) {
-					//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Actor Destroyed %s"), *Actor->GetName()));
-					Actor->Destroy();
-					UE_LOG(LogSpawnCorridor, Log, TEXT("Destroyed actor: %s"), *Actor->GetName());
-				}
-				});
-			}
-		};
+	// Pieces go to the dungeon queue which destroys them in batches, standalone corridors destroy in place
+	PieceTable.DestroyPieces(ERoomPieceFlags::AllCategories, GetDestructionQueue());
+	DungeonCollision::DestroyBoxes(CollisionBoxes);
 
-	for (AActor* Wall : CorridorObjects.WallObject) {
-		SafeDestroyActor(Wall);
-	}
 	CorridorObjects.WallObject.Empty();
+	CorridorObjects.RoofObject.Empty();
+	CorridorObjects.FloorObject.Empty();
+}
 
-	for (AActor* Roof : CorridorObjects.RoofObject) {
-		SafeDestroyActor(Roof);
+// Piece actors and their classes are only held by the piece table
+void ASpawnCorridor::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) {
+	CastChecked<ASpawnCorridor>(InThis)->PieceTable.AddReferencedObjects(Collector);
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+// Pieces, collision boxes and the lists kept for them
+void ASpawnCorridor::CollectMemoryStats(FDungeonMemoryStats& OutStats) const {
+	OutStats.Pieces += PieceTable.Num();
+	for (const FRoomPieceHandle& Handle : PieceTable.GetHandles()) {
+		if (Handle.Kind == ERoomPieceHandleKind::Actor) {
+			DungeonMemory::AccumulateActor(Handle.Actor, OutStats);
+		}
 	}
-	CorridorObjects.RoofObject.Empty();
+	DungeonMemory::AccumulateActor(this, OutStats);
 
-	for (AActor* Floor : CorridorObjects.FloorObject) {
-		SafeDestroyActor(Floor);
+	OutStats.ContainerBytes += PieceTable.GetAllocatedSize() + CollisionBoxes.GetAllocatedSize() + CorridorAssetData.GetAllocatedSize();
+	OutStats.ContainerBytes += CorridorObjects.WallObject.GetAllocatedSize() + CorridorObjects.FloorObject.GetAllocatedSize() + CorridorObjects.RoofObject.GetAllocatedSize();
+	for (const FAssetStruct& AssetInfo : CorridorAssetData) {
+		OutStats.ContainerBytes += AssetInfo.AssetName.GetAllocatedSize() + AssetInfo.Directory.GetAllocatedSize();
 	}
-	CorridorObjects.FloorObject.Empty();
+}
+
+// Register a collision box of the server profile as an instance piece
+void ASpawnCorridor::AddCollisionPiece(UBoxComponent* Box, ERoomPieceCategory Category) {
+	if (Box) {
+		PieceTable.AddSlot(CollisionBoxes.Add(Box), ERoomPieceHandleKind::Instance, UBoxComponent::StaticClass(), Box->GetComponentTransform(), Category);
+	}
+}
+
+// Hide or show every piece of the corridor in one pass over the piece table
+void ASpawnCorridor::SetCorridorHidden(bool bHidden) {
+	PieceTable.SetHidden(ERoomPieceFlags::AllCategories, bHidden);
 }
 
 void ASpawnCorridor::AssignCorridorAssets(const FString& FilePath) {
+	LLM_SCOPE_BYTAG(DungeonAssets);
+
 	// Load all room assets
 	FRoomAssetStruct AllRoomAssets = URoomAssetLoader::LoadRoomAsset(FilePath);
 
@@ -1,18 +1,83 @@
 #include "Generators/SpawnDungeon.h"
+#include "Generators/DungeonMemory.h"
+#include "Generators/RoomShapeCache.h"
 #include "Utilities/LoggingTool.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
 
 DEFINE_LOG_CATEGORY(LogSpawnDungeon);
 
+static TAutoConsoleVariable<bool> CVarDungeonCollectAfterEviction(
+	TEXT("Dungeon.CollectAfterEviction"),
+	false,
+	TEXT("Request a garbage collection once the pieces of evicted rooms and corridors are destroyed. Off by default, the regular (or incremental) collection releases them without a hitch; turn it on only where a capture shows the eviction holding memory too long."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DungeonMemReportCommand(
+	TEXT("Dungeon.MemReport"),
+	TEXT("Print memory and piece counts per room, per corridor and per dungeon instance."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		if (!World) {
+			return;
+		}
+
+		int32 Dungeons = 0;
+		for (TActorIterator<ASpawnDungeon> It(World); It; ++It) {
+			It->DumpMemoryReport(Ar);
+			Dungeons++;
+		}
+
+		// The shape cache is shared by every dungeon of the process
+		const FRoomShapeCache& ShapeCache = FRoomShapeCache::Get();
+		Ar.Logf(TEXT("%d dungeon(s), shape cache: %d templates, %s"), Dungeons, ShapeCache.Num(), *DungeonMemory::FormatBytes(ShapeCache.GetAllocatedSize()));
+		}));
+
 ASpawnDungeon::ASpawnDungeon(){
 	PrimaryActorTick.bCanEverTick = true;
 
-	CurrentRoomID = 0;
+	NextRoomID = 0;
 	RoomSpawned = 0;
+	Seed = 0;
+	BuildProfile = EDungeonBuildProfile::Auto;
+
+	DestructionBudgetMs = 1.f;
+	MaxPiecesDestroyedPerFrame = 32;
+
+	FullDetailRoomRadius = 1;
+	MaxDetailStepsPerFrame = 1;
+
+	PhysicsRoomRadius = 1;
+	PhysicsActivationDistance = 0.f;
+	MaxPhysicsPiecesPerFrame = 64;
+
+	bEnablePortalCulling = true;
+	LastViewNode = INDEX_NONE;
+	bPortalVisibilityDirty = true;
+	bCollectWhenQueueDrained = false;
+
+	ChunkSize = 8000.f;
+	bUseLayoutCache = true;
 }
 
 void ASpawnDungeon::BeginPlay(){
 	Super::BeginPlay();
 
+	// Each instance draws from its own stream, so several dungeons in one world never share random state
+	if (Seed != 0) {
+		RandomStream.Initialize(Seed);
+	}
+	else {
+		RandomStream.GenerateNewSeed();
+	}
+
+	// Chunk plans hang off the seed, a fixed seed finds the layouts of earlier sessions on disk.
+	// A random seed never comes back, its file would only pile up in Saved
+	ChunkCache.Initialize(GetSeed(), ChunkSize);
+	if (bUseLayoutCache and Seed != 0) {
+		ChunkCache.Load();
+	}
+
 	// Start the timer to continuously check the player's room
 	GetWorld()->GetTimerManager().SetTimer(DungeonCheckTimerHandle, this, &ASpawnDungeon::GenerateDungeonEternal, 1.f, true);
 	ULoggingTool::LogDebugMessage(TEXT("BeginPlay: Dungeon generation started."));
@@ -20,8 +85,53 @@ void ASpawnDungeon::BeginPlay(){
 	GenerateDungeonOnBoot();
 }
 
+void ASpawnDungeon::EndPlay(const EEndPlayReason::Type EndPlayReason){
+	// Nothing is left behind once the dungeon goes away
+	DestructionQueue.Flush();
+
+	if (bUseLayoutCache and Seed != 0) {
+		ChunkCache.Save();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ASpawnDungeon::Tick(float DeltaTime){
 	Super::Tick(DeltaTime);
+
+	// Destroy pieces of cleared rooms and corridors a batch at a time
+	if (!DestructionQueue.IsEmpty()) {
+		DestructionQueue.ProcessBatch(DestructionBudgetMs / 1000.f, MaxPiecesDestroyedPerFrame);
+
+		// Opt in only: a forced full collection stalls the frame, the periodic one frees the same objects a little later
+		if (DestructionQueue.IsEmpty() and bCollectWhenQueueDrained) {
+			bCollectWhenQueueDrained = false;
+			if (GEngine and CVarDungeonCollectAfterEviction.GetValueOnGameThread()) {
+				GEngine->ForceGarbageCollection(false);
+			}
+		}
+	}
+
+	StepPhysicsActivation();
+
+	if (bEnablePortalCulling) {
+		UpdatePortalVisibility();
+	}
+
+	// Move rooms towards their detail tier a few stages per frame
+	int32 StepsLeft = MaxDetailStepsPerFrame;
+	for (ASpawnRoom* Room : RoomDungeon) {
+		if (StepsLeft <= 0) {
+			break;
+		}
+		if (Room and Room->NeedsDetailStep()) {
+			Room->StepDetailLevel();
+			StepsLeft--;
+
+			// Pieces added by the step pick up the hidden state on the next pass
+			bPortalVisibilityDirty = true;
+		}
+	}
 }
 
 void ASpawnDungeon::InitAssets(TSubclassOf<AActor> FloorClass, TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLightned, TSubclassOf<AActor> EntranceClass, TSubclassOf<AActor> RoofClass){
@@ -35,163 +145,192 @@ void ASpawnDungeon::InitAssets(TSubclassOf<AActor> FloorClass, TSubclassOf<AActo
 
 // Generates the initial dungeon layout at game start
 void ASpawnDungeon::GenerateDungeonOnBoot() {
+	LLM_SCOPE_BYTAG(DungeonLayout);
 	UWorld* World = GetWorld();
 	if (World) {
 		FVector StartLocation = FVector::ZeroVector;
-		FRotator StartRotation = FRotator::ZeroRotator;
 
 		if (RoomDungeon.IsEmpty()) {
 			// Spawn the initial room
-			ASpawnRoom* RoomInitial = World->SpawnActor<ASpawnRoom>(ASpawnRoom::StaticClass(), StartLocation, StartRotation);
+			ASpawnRoom* RoomInitial = SpawnDungeonRoom(World, StartLocation, ChunkCache.FindOrPlanRoom(StartLocation, EDungeonOrientation::Forward));
+			if (!RoomInitial) {
+				return;
+			}
 
 			RoomInitial->SetParamRoomTag("Initial Room");
 
-			if (RoomInitial) {
-				// Create an entrance structure for the initial room
-				FEntranceStruct InitialEntrance = FEntranceStruct(DefaultEntranceClass, 0, true, FVector::ZeroVector, FRotator::ZeroRotator);
+			// Players spawn here, so this room needs collision before its first piece exists
+			RoomInitial->SetPhysicsActive(true);
 
-				RoomInitial->CreateRoom(InitialEntrance);
-				ULoggingTool::LogDebugMessage(TEXT("Initial Room Created"));
-			}
+			// Create an entrance structure for the initial room
+			FEntranceStruct InitialEntrance = FEntranceStruct(DefaultEntranceClass, 0, true, FVector::ZeroVector, FRotator::ZeroRotator);
 
-			// Assign Room ID and set it as the current room
-			CurrentRoomID = RoomInitial->GetParamRoomID();
+			RoomInitial->CreateRoom(InitialEntrance);
+			ULoggingTool::LogDebugMessage(TEXT("Initial Room Created"));
+
+			// Players start in the initial room
+			OccupiedRoomIDs = { RoomInitial->GetParamRoomID() };
 
 			RoomDungeon.Add(RoomInitial);
+			RegisterRoomNode(RoomInitial);
 
 			// Generate additional parts of the dungeon
 			GenerateDungeon(DefaultFloorClass, DefaultWallClass, DefaultWallClassLightned, DefaultEntranceClass, DefaultRoofClass, RoomInitial);
+			UpdateDetailTargets(TArray<ASpawnRoom*>{ RoomInitial });
+			UpdatePhysicsTargets(TArray<ASpawnRoom*>{ RoomInitial });
 		}
 	}
 }
 
 // Generates additional parts of the dungeon
 void ASpawnDungeon::GenerateDungeon(TSubclassOf<AActor> FloorClass, TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLightned, TSubclassOf<AActor> EntranceClass, TSubclassOf<AActor> RoofClass, ASpawnRoom* RoomOfOrigin){
+	// Layout by default, rooms and corridors switch to their own tags while they build
+	LLM_SCOPE_BYTAG(DungeonLayout);
 	UWorld* World = GetWorld();
 
 	if (!World or !RoomOfOrigin) return;
 
 	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Generating dungeon from room ID: %d"), RoomOfOrigin->GetParamRoomID()));
 
+	// Origin and its entrances are the anchors new corridors connect to
+	RegisterRoomNode(RoomOfOrigin);
+
+	// Corridors spawned for this origin, with the entrance they leave from and the plan of the room behind them
+	TArray<TTuple<ASpawnCorridor*, AActor*, FDungeonRoomPlan>> NewCorridors;
+
 	// Set corridors connected to the original room
 	for (AActor* Entrance : RoomOfOrigin->RoomObjects.EntranceObject) {
+		// Entrances whose corridor survived the last clear already lead to an occupied room
+		if (!Entrance or IsEntranceConnected(Entrance)) {
+			continue;
+		}
+
 		// Spawn a new corridor
 		ASpawnCorridor* Corridor = World->SpawnActor<ASpawnCorridor>(ASpawnCorridor::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator);
 
 		if (Corridor) {
-			SetCorridorParameters(Corridor, Entrance);
+			// Same entrance, same chunk, same corridor and room, whether planned now or read from the cache
+			const FDungeonRoomPlan Plan = ChunkCache.FindOrPlanRoom(Entrance->GetActorLocation(), DungeonGrid::FromYaw(Entrance->GetActorRotation().Yaw));
+
+			Corridor->SetOwningDungeon(this);
+			Corridor->SetCollisionOnly(IsCollisionOnly());
+			SetCorridorParameters(Corridor, Entrance, Plan.CorridorWalls);
 			Corridor->CreateCorridor();
 			ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Corridor created at location: %s"), *Corridor->GetActorLocation().ToString()));
+
+			// Room -> entrance -> corridor
+			const FDungeonNodeId CorridorNode = DungeonGraph.AddNode(EDungeonNodeType::Corridor);
+			BindNodeActor(CorridorNode, Corridor);
+			DungeonGraph.Connect(GetNodeOfActor(Entrance), CorridorNode);
+
+			CorridorDungeon.Add(Corridor);
+			NewCorridors.Emplace(Corridor, Entrance, Plan);
 		}
-		CorridorDungeon.Add(Corridor);
 	}
 
 	// Set rooms connected to the corridors
 	TArray<FEntranceStruct> EntranceInfo;
 
-	// Ensure the number of corridors matches the number of entrances
-	check(CorridorDungeon.Num() == RoomOfOrigin->RoomObjects.EntranceObject.Num());
+	for (const TTuple<ASpawnCorridor*, AActor*, FDungeonRoomPlan>& NewCorridor : NewCorridors) {
+		ASpawnCorridor* Corridor = NewCorridor.Get<0>();
+		AActor* Entrance = NewCorridor.Get<1>();
+		const FDungeonRoomPlan& Plan = NewCorridor.Get<2>();
 
-	for (int32 Index = 0; Index < CorridorDungeon.Num(); Index++) {
-		ASpawnCorridor* Corridor = CorridorDungeon[Index];
-		AActor* Entrance = RoomOfOrigin->RoomObjects.EntranceObject[Index];
-		if (Corridor and Entrance) {
-			FVector Direction = GetEntranceDirection(Entrance->GetActorRotation());
-			float OffsetDistance = GetOffsetDistance(Corridor);
-			FVector NewLocation = GetNewLocation(Entrance->GetActorLocation(), Direction, OffsetDistance);
+		FVector Direction = GetEntranceDirection(Entrance->GetActorRotation());
+		float OffsetDistance = GetOffsetDistance(Corridor);
+		FVector NewLocation = GetNewLocation(Entrance->GetActorLocation(), Direction, OffsetDistance);
 
-			// Create an entrance structure
-			FEntranceStruct NewEntrance = FEntranceStruct(EntranceClass, -1, true, NewLocation, Entrance->GetActorRotation());
+		// Create an entrance structure
+		FEntranceStruct NewEntrance = FEntranceStruct(EntranceClass, -1, true, NewLocation, Entrance->GetActorRotation());
 
-			// Spawn a new room
-			ASpawnRoom* Room = World->SpawnActor<ASpawnRoom>(ASpawnRoom::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator);
+		// Spawn a new room
+		ASpawnRoom* Room = SpawnDungeonRoom(World, FVector::ZeroVector, Plan);
+		if (!Room) {
+			continue;
+		}
 
-			float OriginalYaw = NewEntrance.EntranceRotation.Yaw;
-			int32 RandomRangeValue = GetRandomRangeValue(Room, OriginalYaw);
+		float OriginalYaw = NewEntrance.EntranceRotation.Yaw;
+		NewEntrance.EntranceID = Plan.EntranceIndex;
 
-			NewEntrance.EntranceID = RandomRangeValue;
+		float NewYaw = GetNewYaw(OriginalYaw);
+		NewEntrance.EntranceRotation = FRotator(0.f, NewYaw, 0.f);
 
-			float NewYaw = GetNewYaw(OriginalYaw);
-			NewEntrance.EntranceRotation = FRotator(0.f, NewYaw, 0.f);
+		EntranceInfo.Add(NewEntrance);
 
-			EntranceInfo.Add(NewEntrance);
+		// New rooms start as cheap proxies, UpdateDetailTargets decides which ones get upgraded
+		Room->SetTargetDetailLevel(ERoomDetailLevel::Proxy);
+		FVector AdjustVector = GetAdjustVector(Room, NewEntrance);
+		Room->SetParamStartLocation(NewEntrance.EntrancePosition - AdjustVector);
+		Room->CreateRoom(NewEntrance);
+		RoomDungeon.Add(Room);
 
-			if (Room) {
-				FVector AdjustVector = GetAdjustVector(Room, NewEntrance);
-				Room->SetParamStartLocation(NewEntrance.EntrancePosition - AdjustVector);
-				Room->CreateRoom(NewEntrance);
-				RoomDungeon.Add(Room);
-				ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room created with ID: %d"), Room->GetParamRoomID()));
-			}
-		}
+		// Corridor -> entrance of the new room -> new room
+		const FDungeonNodeId RoomNode = RegisterRoomNode(Room);
+		AActor* RoomEntrance = FindClosestEntrance(Room, NewEntrance.EntrancePosition);
+		DungeonGraph.Connect(RoomEntrance ? GetNodeOfActor(RoomEntrance) : RoomNode, GetNodeOfActor(Corridor));
+		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room created with ID: %d"), Room->GetParamRoomID()));
 	}
 }
 
-// Continuously checks and regenerates the dungeon when the player moves to a new room
+// Continuously checks and regenerates the dungeon when the tracked players move to new rooms
 void ASpawnDungeon::GenerateDungeonEternal(){
 	UWorld* World = GetWorld();
 	if (!World) return;
-	APawn* PlayerPawn = GetPlayePawn();
-	
-	if (!PlayerPawn) return;
-	ASpawnRoom* CurrentRoom = GetCurrentRoom(PlayerPawn);
-	
-	if (!CurrentRoom or CurrentRoom->GetParamRoomID() == CurrentRoomID) return;
 
-	AsyncTask(ENamedThreads::GameThread, [this, CurrentRoom]() {
-		ClearDungeon(CurrentRoom);
+	TArray<ASpawnRoom*> CurrentRooms;
+	ASpawnRoom* CurrentViewerRoom = nullptr;
+	GetOccupiedRooms(CurrentRooms, &CurrentViewerRoom);
+	ViewerRoom = CurrentViewerRoom;
+	if (CurrentRooms.IsEmpty()) return;
+
+	TArray<int32> CurrentRoomIDs;
+	for (ASpawnRoom* Room : CurrentRooms) {
+		CurrentRoomIDs.Add(Room->GetParamRoomID());
+	}
+	CurrentRoomIDs.Sort();
+
+	// Distance based activation follows players inside a room as well, not only across transitions
+	UpdatePhysicsTargets(CurrentRooms);
+
+	if (CurrentRoomIDs == OccupiedRoomIDs) return;
+
+	// Every occupied room survives the clear, together with the corridors between them
+	AsyncTask(ENamedThreads::GameThread, [this, CurrentRooms]() {
+		ClearDungeon(CurrentRooms);
 		});
 
 	TSubclassOf<AActor> FloorClass = DefaultFloorClass, WallClass = DefaultWallClass, WallClassLightned = DefaultWallClassLightned, EntranceClass = DefaultEntranceClass, RoofClass = DefaultRoofClass;
 
 	// Generate dungeon asynchronously
-	AsyncTask(ENamedThreads::GameThread, [this, FloorClass, WallClass, WallClassLightned, EntranceClass, RoofClass, CurrentRoom]() {
-		GenerateDungeon(FloorClass, WallClass, WallClassLightned, EntranceClass, RoofClass, CurrentRoom);
+	AsyncTask(ENamedThreads::GameThread, [this, FloorClass, WallClass, WallClassLightned, EntranceClass, RoofClass, CurrentRooms]() {
+		for (ASpawnRoom* CurrentRoom : CurrentRooms) {
+			GenerateDungeon(FloorClass, WallClass, WallClassLightned, EntranceClass, RoofClass, CurrentRoom);
+		}
+		UpdateDetailTargets(CurrentRooms);
+		UpdatePhysicsTargets(CurrentRooms);
 		});
 	
-	CurrentRoomID = CurrentRoom->GetParamRoomID();
-	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Player moved to new room ID: %d"), CurrentRoomID));
+	OccupiedRoomIDs = MoveTemp(CurrentRoomIDs);
+	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Players moved, %d rooms occupied"), OccupiedRoomIDs.Num()));
 }
 
-void ASpawnDungeon::SetCorridorParameters(ASpawnCorridor* Corridor, AActor* Entrance) {
-	const float Tolerance = 0.1f;
+void ASpawnDungeon::SetCorridorParameters(ASpawnCorridor* Corridor, AActor* Entrance, int32 CorridorWalls) {
 	float Yaw = Entrance->GetActorRotation().Yaw;
 
-	const int32 RandomWalls = FMath::FRandRange(3.f, 12.f);
-	const float WallLength = Corridor->GetParamWallLength();
-	const FVector EntranceLocation = Entrance->GetActorLocation();
-
-	struct FCorridorConfig {
-		int32 ForwardWalls;
-		int32 RightWalls;
-		FVector Offset;
-	};
-
-	// Mapping of Yaw values to corridor configurations
-	TMap<float, FCorridorConfig> YawConfigMap = {
-		{ 0.f  , {1, RandomWalls, FVector(0.f, WallLength * RandomWalls, 0.f)}},
-		{ 90.f , {RandomWalls, 1, FVector(-WallLength / 2, WallLength / 2, 0.f)}},
-		{ 180.f, {1, RandomWalls, FVector::ZeroVector}},
-		{ -90.f, {RandomWalls, 1, FVector(WallLength * RandomWalls - WallLength / 2, WallLength / 2, 0.f)}}
-	};
-
-	const bool bFoundConfig = false;
-
-	// Apply the appropriate corridor configuration based on the Yaw value
-	for (const auto& Entry : YawConfigMap) {
-		if (FMath::IsNearlyEqual(Yaw, Entry.Key, Tolerance)) {
-			const FCorridorConfig& Config = Entry.Value;
-			Corridor->SetParamForwardWalls(Config.ForwardWalls);
-			Corridor->SetParamRightWalls(Config.RightWalls);
-			Corridor->SetParamStartLocation(EntranceLocation - Config.Offset);
-			ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Corridor parameters set for Yaw: %f"), Yaw));
-			return;
-		}
-	}
-
-	if (!bFoundConfig) {
+	EDungeonOrientation Orientation;
+	if (!DungeonGrid::TryFromYaw(Yaw, Orientation, 0.1f)) {
 		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Oops, something went wrong. Unexpected Yaw: %f"), Yaw), FColor::Red);
+		return;
 	}
+
+	// Planned length goes along the axis the corridor leaves the entrance on, the other side is a single wall
+	const bool bLengthAlongForward = DungeonGrid::CorridorTable[DungeonGrid::Index(Orientation)].bLengthAlongForward;
+	const FVector Offset = DungeonGrid::ToWorldOffset(DungeonGrid::GetCorridorOffset(Orientation, CorridorWalls), Corridor->GetParamWallLength());
+
+	Corridor->SetParamForwardWalls(bLengthAlongForward ? CorridorWalls : 1);
+	Corridor->SetParamRightWalls(bLengthAlongForward ? 1 : CorridorWalls);
+	Corridor->SetParamStartLocation(Entrance->GetActorLocation() - Offset);
+	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Corridor parameters set for Yaw: %f"), Yaw));
 }
 
 // Method to get entrance direction
@@ -209,67 +348,130 @@ FVector ASpawnDungeon::GetNewLocation(FVector EntranceLocation, FVector Directio
 	return EntranceLocation - Direction * OffsetDistance;
 }
 
-// Method to get random range value based on yaw
-int32 ASpawnDungeon::GetRandomRangeValue(ASpawnRoom * Room, float OriginalYaw) {
-	int32 RandomRangeValue = 0;
-	float AdjustedYaw = FMath::Fmod(FMath::Abs(OriginalYaw), 360.f);
+// Method to write planned chunk layouts to disk right away instead of waiting for EndPlay
+bool ASpawnDungeon::SaveLayoutCache() {
+	return ChunkCache.Save();
+}
 
-	TMap<float, int32> RandomRangeMap = {
-		{0.f, Room->GetParamForwardWalls() - FMath::RandRange(1, Room->GetParamForwardWalls() - 1)},
-		{180.f, Room->GetParamForwardWalls() - FMath::RandRange(1, Room->GetParamForwardWalls() - 1)},
-		{90.f, Room->GetParamRightWalls() - FMath::RandRange(1, Room->GetParamRightWalls() - 1)},
-		{-90.f, Room->GetParamRightWalls() - FMath::RandRange(1, Room->GetParamRightWalls() - 1)}
-	};
+// Method to get new yaw based on original yaw
+float ASpawnDungeon::GetNewYaw(float OriginalYaw) {
+	EDungeonOrientation Orientation;
+	if (!DungeonGrid::TryFromYaw(OriginalYaw, Orientation)) {
+		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Oops, something went wrong. Unexpected original yaw angle: %f"), OriginalYaw), FColor::Red);
+		return 0.f;
+	}
 
-	if (RandomRangeMap.Contains(AdjustedYaw)) {
-		RandomRangeValue = RandomRangeMap[AdjustedYaw];
+	// The new room is entered from the opposite side
+	return DungeonGrid::ToYaw(DungeonGrid::Opposite(Orientation));
+}
+
+// Method to get adjustment vector based on yaw and entrance ID
+FVector ASpawnDungeon::GetAdjustVector(ASpawnRoom* Room, FEntranceStruct NewEntrance) {
+	EDungeonOrientation Orientation;
+	if (!DungeonGrid::TryFromYaw(NewEntrance.EntranceRotation.Yaw, Orientation)) {
+		return FVector::ZeroVector;
 	}
-	else {
-		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Oops, something went wrong. Unexpected original yaw angle: %f"), OriginalYaw), FColor::Red);
+
+	const FIntPoint Anchor = DungeonGrid::GetAnchor(Orientation, Room->GetParamForwardWalls(), Room->GetParamRightWalls(), NewEntrance.EntranceID);
+	return DungeonGrid::ToWorldOffset(Anchor, Room->GetParamWallLength());
+}
+
+// Method to spawn a room owned by this dungeon instance
+ASpawnRoom* ASpawnDungeon::SpawnDungeonRoom(UWorld* World, FVector Location, const FDungeonRoomPlan& Plan) {
+	ASpawnRoom* Room = World->SpawnActor<ASpawnRoom>(ASpawnRoom::StaticClass(), Location, FRotator::ZeroRotator);
+	if (!Room) {
+		return nullptr;
 	}
 
-	return RandomRangeValue;
+	Room->SetParamRoomID(NextRoomID++);
+	Room->SetRandomSeed(Plan.RoomSeed);
+	Room->SetParamForwardWalls(Plan.ForwardWalls);
+	Room->SetParamRightWalls(Plan.RightWalls);
+	Room->SetOwningDungeon(this);
+	Room->SetCollisionOnly(IsCollisionOnly());
+
+	// Rooms start without collision, UpdatePhysicsTargets switches on the ones near players
+	Room->SetPhysicsActive(false);
+	return Room;
 }
 
-// Method to get new yaw based on original yaw
-float ASpawnDungeon::GetNewYaw(float OriginalYaw) {
-	TMap<float, float> YawAngleMap = {
-		{0.f, 180.f},
-		{90.f, -90.f},
-		{180.f, 0.f},
-		{-90.f, 90.f}
-	};
+bool ASpawnDungeon::IsCollisionOnly() const {
+	if (BuildProfile == EDungeonBuildProfile::Auto) {
+		return GetNetMode() == NM_DedicatedServer;
+	}
+	return BuildProfile == EDungeonBuildProfile::CollisionOnly;
+}
 
-	if (YawAngleMap.Contains(OriginalYaw)) {
-		return YawAngleMap[OriginalYaw];
+void ASpawnDungeon::AssignPlayer(APlayerController* Player) {
+	if (Player) {
+		AssignedPlayers.AddUnique(Player);
 	}
-	else {
-		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Oops, something went wrong. Unexpected original yaw angle: %f"), OriginalYaw), FColor::Red);
-		return 0.f;
+}
+
+void ASpawnDungeon::UnassignPlayer(APlayerController* Player) {
+	AssignedPlayers.Remove(Player);
+	AssignedPlayers.RemoveAll([](const TWeakObjectPtr<APlayerController>& Assigned) { return !Assigned.IsValid(); });
+}
+
+// Method to get the pawns of the players this instance follows
+void ASpawnDungeon::GetTrackedPawns(TArray<APawn*>& OutPawns) const {
+	OutPawns.Reset();
+
+	if (!AssignedPlayers.IsEmpty()) {
+		for (const TWeakObjectPtr<APlayerController>& Player : AssignedPlayers) {
+			APawn* Pawn = Player.IsValid() ? Player->GetPawn() : nullptr;
+			if (Pawn) {
+				OutPawns.Add(Pawn);
+			}
+		}
+		return;
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		APlayerController* PlayerController = It->Get();
+		APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+		if (Pawn) {
+			OutPawns.Add(Pawn);
+		}
 	}
 }
 
-// Method to get adjustment vector based on yaw and entrance ID
-FVector ASpawnDungeon::GetAdjustVector(ASpawnRoom* Room, FEntranceStruct NewEntrance) {
-	TMap<float, FVector> VectorConfigMap = {
-		{0.f, FVector((Room->GetParamForwardWalls() - NewEntrance.EntranceID - 1) * Room->GetParamWallLength(), 0.f, 0.f)},
-		{90.f, FVector(Room->GetParamForwardWalls() * Room->GetParamWallLength() - Room->GetParamWallLength() / 2, NewEntrance.EntranceID * Room->GetParamWallLength() + Room->GetParamWallLength() / 2, 0.f)},
-		{180.f, FVector((Room->GetParamForwardWalls() - NewEntrance.EntranceID - 1) * Room->GetParamWallLength(), Room->GetParamRightWalls() * Room->GetParamWallLength(), 0.f)},
-		{-90.f, FVector(-Room->GetParamWallLength() / 2, (Room->GetParamRightWalls() - NewEntrance.EntranceID) * Room->GetParamWallLength() - Room->GetParamWallLength() / 2, 0.f)}
-	};
+// Method to get the rooms the tracked players are in
+void ASpawnDungeon::GetOccupiedRooms(TArray<ASpawnRoom*>& OutRooms, ASpawnRoom** OutViewerRoom) {
+	OutRooms.Reset();
 
-	if (VectorConfigMap.Contains(NewEntrance.EntranceRotation.Yaw)) {
-		return VectorConfigMap[NewEntrance.EntranceRotation.Yaw];
+	APlayerController* Viewer = OutViewerRoom ? GetLocalViewer() : nullptr;
+	APawn* ViewerPawn = Viewer ? Viewer->GetPawn() : nullptr;
+	bool bViewerTracked = false;
+
+	TArray<APawn*> Pawns;
+	GetTrackedPawns(Pawns);
+	for (APawn* Pawn : Pawns) {
+		ASpawnRoom* Room = GetCurrentRoom(Pawn);
+		if (Room) {
+			OutRooms.AddUnique(Room);
+		}
+		if (Pawn == ViewerPawn) {
+			*OutViewerRoom = Room;
+			bViewerTracked = true;
+		}
 	}
-	else {
-		return FVector::ZeroVector;
+
+	// A viewer that is not one of the tracked players still needs its own room
+	if (OutViewerRoom and !bViewerTracked) {
+		*OutViewerRoom = ViewerPawn ? GetCurrentRoom(ViewerPawn) : nullptr;
 	}
 }
 
-// Method to get Player's pawn
-APawn* ASpawnDungeon::GetPlayePawn() const{
-	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
-	return PlayerController ? PlayerController->GetPawn() : nullptr;
+// Method to get the locally controlled player, dedicated servers have none
+APlayerController* ASpawnDungeon::GetLocalViewer() const {
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController and PlayerController->IsLocalController()) {
+			return PlayerController;
+		}
+	}
+	return nullptr;
 }
 
 // Method to get current room
@@ -279,51 +481,433 @@ ASpawnRoom* ASpawnDungeon::GetCurrentRoom(APawn* PlayerPawn){
 			return Room;
 		}
 	}
+
+	// Detectors of inactive rooms generate no overlaps, a player teleported into one is found by bounds
+	const FVector PawnLocation = PlayerPawn->GetActorLocation();
+	for (ASpawnRoom* Room : RoomDungeon) {
+		if (Room and !Room->IsPhysicsActive() and Room->GetRoomBounds().IsInsideXY(PawnLocation)) {
+			return Room;
+		}
+	}
 	return nullptr;
 }
 
 // Method to clear dungeon rooms
-void ASpawnDungeon::ClearDungeon(ASpawnRoom* RoomToSkip) {
+void ASpawnDungeon::ClearDungeon(const TArray<ASpawnRoom*>& RoomsToKeep) {
 	// Ensure this runs on the game thread
 	if (!IsInGameThread()) {
-		AsyncTask(ENamedThreads::GameThread, [this, RoomToSkip]() {
-			ClearDungeon(RoomToSkip);
+		AsyncTask(ENamedThreads::GameThread, [this, RoomsToKeep]() {
+			ClearDungeon(RoomsToKeep);
 			});
 		return;
 	}
 
 	UWorld* World = GetWorld();
 	if (World) {
+		// Corridors linking two kept rooms stay, decided before the room nodes go away
+		TSet<FDungeonNodeId> KeptRoomNodes;
+		for (ASpawnRoom* Room : RoomsToKeep) {
+			KeptRoomNodes.Add(GetNodeOfActor(Room));
+		}
+
+		TArray<ASpawnCorridor*> CorridorsToKeep;
+		for (ASpawnCorridor* Corridor : CorridorDungeon) {
+			if (Corridor and LinksKeptRooms(GetNodeOfActor(Corridor), KeptRoomNodes)) {
+				CorridorsToKeep.Add(Corridor);
+			}
+		}
+
 		for (ASpawnRoom* Room : RoomDungeon) {
-			if (Room != RoomToSkip and Room) {
+			if (Room and !RoomsToKeep.Contains(Room)) {
+				UnregisterNode(Room);
 				Room->DestroyRoom();
-				Room->Destroy();
+				DestructionQueue.Enqueue(Room);
+				bCollectWhenQueueDrained = true;
 			}
 		}
 		RoomDungeon.Empty();
-		RoomDungeon.Add(RoomToSkip);
+		RoomDungeon.Append(RoomsToKeep);
 
 		// Clear corridors if any
-		ClearCorridors();
+		ClearCorridors(CorridorsToKeep);
 	}
 }
 
 // Method to clear corridors
-void ASpawnDungeon::ClearCorridors() {
+void ASpawnDungeon::ClearCorridors(const TArray<ASpawnCorridor*>& CorridorsToKeep) {
 	if (!IsInGameThread()) {
-		AsyncTask(ENamedThreads::GameThread, [this]() {
-			ClearCorridors();
+		AsyncTask(ENamedThreads::GameThread, [this, CorridorsToKeep]() {
+			ClearCorridors(CorridorsToKeep);
 			});
 		return;
 	}
 	UWorld* World = GetWorld();
 	if (World) {
 		for (ASpawnCorridor* Corridor : CorridorDungeon) {
-			if (Corridor) {
+			if (Corridor and !CorridorsToKeep.Contains(Corridor)) {
+				UnregisterNode(Corridor);
 				Corridor->DestroyCorridor();
-				Corridor->Destroy();
+				DestructionQueue.Enqueue(Corridor);
+				bCollectWhenQueueDrained = true;
+			}
+		}
+		CorridorDungeon = CorridorsToKeep;
+	}
+}
+
+// Method to check if every entrance a corridor touches belongs to a kept room
+bool ASpawnDungeon::LinksKeptRooms(FDungeonNodeId CorridorNode, const TSet<FDungeonNodeId>& KeptRoomNodes) const {
+	TArray<FDungeonNodeId> Neighbours;
+	DungeonGraph.GetNeighbours(CorridorNode, Neighbours);
+	if (Neighbours.Num() < 2) {
+		return false;
+	}
+
+	for (FDungeonNodeId Neighbour : Neighbours) {
+		const FDungeonNode* Node = DungeonGraph.GetNode(Neighbour);
+		const FDungeonNodeId Room = Node->Type == EDungeonNodeType::Entrance ? Node->OwnerId : Neighbour;
+		if (!KeptRoomNodes.Contains(Room)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Method to check if an entrance already leads into a corridor
+bool ASpawnDungeon::IsEntranceConnected(const AActor* Entrance) const {
+	TArray<FDungeonNodeId> Neighbours;
+	DungeonGraph.GetNeighbours(GetNodeOfActor(Entrance), Neighbours);
+	for (FDungeonNodeId Neighbour : Neighbours) {
+		if (DungeonGraph.GetNode(Neighbour)->Type == EDungeonNodeType::Corridor) {
+			return true;
+		}
+	}
+	return false;
+}
+// Method to add a room and its entrances to the graph, returns the existing node when already registered
+FDungeonNodeId ASpawnDungeon::RegisterRoomNode(ASpawnRoom* Room) {
+	if (const FDungeonNodeId* Existing = ActorNodes.Find(Room)) {
+		return *Existing;
+	}
+
+	const FDungeonNodeId RoomNode = DungeonGraph.AddNode(EDungeonNodeType::Room, FName(*Room->GetParamRoomTag()));
+	BindNodeActor(RoomNode, Room);
+
+	// Entrances are owned by the room, removing the room removes them too
+	for (AActor* Entrance : Room->RoomObjects.EntranceObject) {
+		const FDungeonNodeId EntranceNode = DungeonGraph.AddNode(EDungeonNodeType::Entrance, NAME_None, RoomNode);
+		BindNodeActor(EntranceNode, Entrance);
+		DungeonGraph.Connect(RoomNode, EntranceNode);
+
+		// Entrances never move, their bounds are the portals of the visibility pass
+		if (Entrance) {
+			PortalBounds.Add(EntranceNode, Entrance->GetComponentsBoundingBox());
+		}
+	}
+	return RoomNode;
+}
+
+// Method to remove a room or corridor and everything it owns from the graph
+void ASpawnDungeon::UnregisterNode(AActor* Actor) {
+	FDungeonNodeId Node;
+	if (!ActorNodes.RemoveAndCopyValue(Actor, Node)) {
+		return;
+	}
+
+	NodeActors.Remove(Node);
+	PortalBounds.Remove(Node);
+	bPortalVisibilityDirty = true;
+
+	// Owned entrances go with it, forget their actors as well
+	for (auto It = ActorNodes.CreateIterator(); It; ++It) {
+		const FDungeonNode* GraphNode = DungeonGraph.GetNode(It.Value());
+		if (GraphNode and GraphNode->OwnerId == Node) {
+			NodeActors.Remove(It.Value());
+			PortalBounds.Remove(It.Value());
+			It.RemoveCurrent();
+		}
+	}
+	DungeonGraph.RemoveNode(Node);
+}
+
+void ASpawnDungeon::BindNodeActor(FDungeonNodeId Node, AActor* Actor) {
+	ActorNodes.Add(Actor, Node);
+	NodeActors.Add(Node, Actor);
+	bPortalVisibilityDirty = true;
+}
+
+// Method to print memory and piece counts of every room and corridor of this instance
+void ASpawnDungeon::DumpMemoryReport(FOutputDevice& Ar) const {
+	Ar.Logf(TEXT("Dungeon %s, seed %d: %d rooms, %d corridors, %d pieces queued for destruction"), *GetName(), GetSeed(), RoomDungeon.Num(), CorridorDungeon.Num(), DestructionQueue.Num());
+
+	FDungeonMemoryStats Total;
+	for (const ASpawnRoom* Room : RoomDungeon) {
+		if (!Room) {
+			continue;
+		}
+
+		FDungeonMemoryStats RoomStats;
+		Room->CollectMemoryStats(RoomStats);
+		const FRoomPieceTable& Pieces = Room->GetPieceTable();
+		Ar.Logf(TEXT("  Room %d [%s] %dx%d %s: %d pieces (%d walls, %d entrances, %d props), %d components, objects %s, containers %s"),
+			Room->GetParamRoomID(), *Room->GetParamRoomTag(), Room->GetParamForwardWalls(), Room->GetParamRightWalls(),
+			Room->GetDetailLevel() == ERoomDetailLevel::Full ? TEXT("full") : TEXT("proxy"),
+			RoomStats.Pieces, Pieces.Count(ERoomPieceFlags::Wall), Pieces.Count(ERoomPieceFlags::Entrance), Pieces.Count(ERoomPieceFlags::Prop), RoomStats.Components,
+			*DungeonMemory::FormatBytes(RoomStats.ObjectBytes), *DungeonMemory::FormatBytes(RoomStats.ContainerBytes));
+		Total += RoomStats;
+	}
+
+	FDungeonMemoryStats CorridorTotal;
+	for (const ASpawnCorridor* Corridor : CorridorDungeon) {
+		if (Corridor) {
+			Corridor->CollectMemoryStats(CorridorTotal);
+		}
+	}
+	Ar.Logf(TEXT("  Corridors: %d pieces, %d components, objects %s, containers %s"), CorridorTotal.Pieces, CorridorTotal.Components,
+		*DungeonMemory::FormatBytes(CorridorTotal.ObjectBytes), *DungeonMemory::FormatBytes(CorridorTotal.ContainerBytes));
+	Total += CorridorTotal;
+
+	// Layout bookkeeping of the instance itself
+	const SIZE_T LayoutBytes = DungeonGraph.GetAllocatedSize() + ActorNodes.GetAllocatedSize() + NodeActors.GetAllocatedSize() + PortalBounds.GetAllocatedSize()
+		+ NodeViewRects.GetAllocatedSize() + PortalFrontier.GetAllocatedSize() + PortalNeighbours.GetAllocatedSize();
+	Ar.Logf(TEXT("  Layout: %d graph nodes, %s"), DungeonGraph.Num(), *DungeonMemory::FormatBytes(LayoutBytes));
+
+	Ar.Logf(TEXT("  Total: %d pieces, %d components, %s"), Total.Pieces, Total.Components, *DungeonMemory::FormatBytes(Total.GetTotalBytes() + LayoutBytes));
+}
+
+FDungeonNodeId ASpawnDungeon::GetNodeOfActor(const AActor* Actor) const {
+	const FDungeonNodeId* Node = ActorNodes.Find(Actor);
+	return Node ? *Node : INDEX_NONE;
+}
+
+// Method to find the entrance of a room closest to a world location
+AActor* ASpawnDungeon::FindClosestEntrance(ASpawnRoom* Room, FVector Location) const {
+	AActor* Closest = nullptr;
+	double ClosestDistance = TNumericLimits<double>::Max();
+	for (AActor* Entrance : Room->RoomObjects.EntranceObject) {
+		const double Distance = Entrance ? FVector::DistSquared(Entrance->GetActorLocation(), Location) : ClosestDistance;
+		if (Distance < ClosestDistance) {
+			ClosestDistance = Distance;
+			Closest = Entrance;
+		}
+	}
+	return Closest;
+}
+
+int32 ASpawnDungeon::GetRoomHopDistance(ASpawnRoom* From, ASpawnRoom* To) const {
+	return DungeonGraph.GetHopDistance(GetNodeOfActor(From), GetNodeOfActor(To));
+}
+
+ASpawnRoom* ASpawnDungeon::FindNearestRoomWithTag(ASpawnRoom* From, const FString& Tag) const {
+	const FDungeonNodeId Found = DungeonGraph.FindNearestRoomWithTag(GetNodeOfActor(From), FName(*Tag));
+	const TWeakObjectPtr<AActor>* Actor = NodeActors.Find(Found);
+	return Actor ? Cast<ASpawnRoom>(Actor->Get()) : nullptr;
+}
+
+TArray<AActor*> ASpawnDungeon::FindPathBetween(AActor* From, AActor* To) const {
+	TArray<AActor*> Result;
+	TArray<FDungeonNodeId> Path;
+	if (DungeonGraph.FindPath(GetNodeOfActor(From), GetNodeOfActor(To), Path)) {
+		for (FDungeonNodeId Node : Path) {
+			const TWeakObjectPtr<AActor>* Actor = NodeActors.Find(Node);
+			Result.Add(Actor ? Actor->Get() : nullptr);
+		}
+	}
+	return Result;
+}
+
+// Method to pick the detail tier of every room from its distance to the closest occupied room
+void ASpawnDungeon::UpdateDetailTargets(const TArray<ASpawnRoom*>& PlayerRooms) {
+	TSet<FDungeonNodeId> NearbyRooms;
+	GetRoomsWithinSteps(PlayerRooms, FullDetailRoomRadius, NearbyRooms);
+
+	for (ASpawnRoom* Room : RoomDungeon) {
+		if (Room) {
+			Room->SetTargetDetailLevel(PlayerRooms.Contains(Room) or NearbyRooms.Contains(GetNodeOfActor(Room)) ? ERoomDetailLevel::Full : ERoomDetailLevel::Proxy);
+		}
+	}
+}
+
+// Method to decide which rooms keep collision and overlaps, by room steps and optionally by distance to a player
+void ASpawnDungeon::UpdatePhysicsTargets(const TArray<ASpawnRoom*>& PlayerRooms) {
+	TSet<FDungeonNodeId> NearbyRooms;
+	GetRoomsWithinSteps(PlayerRooms, PhysicsRoomRadius, NearbyRooms);
+
+	TArray<APawn*> Pawns;
+	if (PhysicsActivationDistance > 0.f) {
+		GetTrackedPawns(Pawns);
+	}
+
+	for (ASpawnRoom* Room : RoomDungeon) {
+		if (!Room) {
+			continue;
+		}
+
+		bool bActive = PlayerRooms.Contains(Room) or NearbyRooms.Contains(GetNodeOfActor(Room));
+		if (!bActive and !Pawns.IsEmpty()) {
+			const FBox Bounds = Room->GetRoomBounds();
+			for (APawn* Pawn : Pawns) {
+				if (Bounds.IsValid and Bounds.ComputeSquaredDistanceToPoint(Pawn->GetActorLocation()) <= FMath::Square(PhysicsActivationDistance)) {
+					bActive = true;
+					break;
+				}
+			}
+		}
+		Room->SetPhysicsActive(bActive);
+	}
+}
+
+// Method to collect the rooms within a number of room steps
+void ASpawnDungeon::GetRoomsWithinSteps(const TArray<ASpawnRoom*>& PlayerRooms, int32 RoomSteps, TSet<FDungeonNodeId>& OutRooms) const {
+	// Room -> entrance -> corridor -> entrance -> room, four graph edges per room step
+	constexpr int32 HopsPerRoom = 4;
+
+	for (ASpawnRoom* PlayerRoom : PlayerRooms) {
+		DungeonGraph.ForEachWithinHops(GetNodeOfActor(PlayerRoom), RoomSteps * HopsPerRoom, [&OutRooms](const FDungeonNode& Node, int32) {
+			if (Node.Type == EDungeonNodeType::Room) {
+				OutRooms.Add(Node.Id);
 			}
+			});
+	}
+}
+
+// Method to switch room collision within the per-frame piece budget
+void ASpawnDungeon::StepPhysicsActivation() {
+	int32 PiecesLeft = MaxPhysicsPiecesPerFrame;
+	for (int32 Pass = 0; Pass < 2 and PiecesLeft > 0; Pass++) {
+		const bool bActivating = Pass == 0;
+		for (ASpawnRoom* Room : RoomDungeon) {
+			if (PiecesLeft <= 0) {
+				break;
+			}
+			if (Room and Room->NeedsPhysicsStep() and Room->IsPhysicsActivating() == bActivating) {
+				PiecesLeft -= Room->StepPhysicsActivation(PiecesLeft);
+			}
+		}
+	}
+}
+
+bool FDungeonPortalView::ProjectBox(const FBox& Box, FBox2D& OutRect) const {
+	FVector Corners[8];
+	Box.GetVertices(Corners);
+
+	OutRect = FBox2D(ForceInit);
+	int32 CornersBehind = 0;
+	for (const FVector& Corner : Corners) {
+		const FVector Delta = Corner - Location;
+		const double Depth = Delta | Forward;
+		if (Depth <= UE_KINDA_SMALL_NUMBER) {
+			CornersBehind++;
+			continue;
 		}
-		CorridorDungeon.Empty();
+		OutRect += FVector2D((Delta | Right) / Depth, (Delta | Up) / Depth);
 	}
-}
\ No newline at end of file
+
+	if (CornersBehind == 8) {
+		return false;
+	}
+	if (CornersBehind > 0) {
+		OutRect = Rect;
+	}
+	return true;
+}
+
+// Method to build the tangent space view of the local player's camera
+bool ASpawnDungeon::BuildPortalView(FDungeonPortalView& OutView) const {
+	APlayerController* PlayerController = GetLocalViewer();
+	if (!PlayerController or !PlayerController->PlayerCameraManager) {
+		return false;
+	}
+
+	const APlayerCameraManager* Camera = PlayerController->PlayerCameraManager;
+	OutView.Location = Camera->GetCameraLocation();
+	OutView.Rotation = Camera->GetCameraRotation();
+	const FRotationMatrix Axes(OutView.Rotation);
+	OutView.Forward = Axes.GetScaledAxis(EAxis::X);
+	OutView.Right = Axes.GetScaledAxis(EAxis::Y);
+	OutView.Up = Axes.GetScaledAxis(EAxis::Z);
+
+	int32 ViewportX = 0, ViewportY = 0;
+	PlayerController->GetViewportSize(ViewportX, ViewportY);
+	const float AspectRatio = ViewportX > 0 and ViewportY > 0 ? static_cast<float>(ViewportX) / ViewportY : 16.f / 9.f;
+
+	const float TanHalfFovX = FMath::Tan(FMath::DegreesToRadians(Camera->GetFOVAngle() * 0.5f));
+	const float TanHalfFovY = TanHalfFovX / AspectRatio;
+	OutView.Rect = FBox2D(FVector2D(-TanHalfFovX, -TanHalfFovY), FVector2D(TanHalfFovX, TanHalfFovY));
+	return true;
+}
+
+// Method to show only rooms and corridors seen through a chain of entrances from the player's room
+void ASpawnDungeon::UpdatePortalVisibility() {
+	// The room comes from the last occupancy check instead of another overlap query every frame
+	const FDungeonNodeId StartNode = GetNodeOfActor(ViewerRoom.Get());
+
+	FDungeonPortalView View;
+	if (StartNode == INDEX_NONE or !BuildPortalView(View)) {
+		return;
+	}
+
+	// Nothing to redo while the camera holds still in the same room and no piece or node came or went
+	const bool bViewUnchanged = StartNode == LastViewNode and View.Location.Equals(LastView.Location, 1.f)
+		and View.Rotation.Equals(LastView.Rotation, 0.1f) and View.Rect == LastView.Rect;
+	if (bViewUnchanged and !bPortalVisibilityDirty) {
+		return;
+	}
+	LastViewNode = StartNode;
+	LastView = View;
+	bPortalVisibilityDirty = false;
+
+	auto ContainsRect = [](const FBox2D& Outer, const FBox2D& Inner) {
+		return Outer.Min.X <= Inner.Min.X and Outer.Min.Y <= Inner.Min.Y and Outer.Max.X >= Inner.Max.X and Outer.Max.Y >= Inner.Max.Y;
+		};
+
+	// Flood through the graph. Crossing an entrance narrows the view to the part of its bounds still in sight,
+	// a node reached again is only revisited when the new view is not already covered by the one it has
+	NodeViewRects.Reset();
+	PortalFrontier.Reset();
+	NodeViewRects.Add(StartNode, View.Rect);
+	PortalFrontier.Add(StartNode);
+
+	for (int32 ReadIndex = 0; ReadIndex < PortalFrontier.Num(); ReadIndex++) {
+		const FDungeonNodeId Current = PortalFrontier[ReadIndex];
+		const FBox2D CurrentRect = NodeViewRects.FindChecked(Current);
+
+		DungeonGraph.GetNeighbours(Current, PortalNeighbours);
+		for (FDungeonNodeId Neighbour : PortalNeighbours) {
+			FBox2D NeighbourRect = CurrentRect;
+
+			const FDungeonNode* Node = DungeonGraph.GetNode(Neighbour);
+			if (Node->Type == EDungeonNodeType::Entrance) {
+				const FBox* Portal = PortalBounds.Find(Neighbour);
+				FBox2D PortalRect;
+				if (!Portal or !View.ProjectBox(*Portal, PortalRect) or !CurrentRect.Intersect(PortalRect)) {
+					continue;
+				}
+				NeighbourRect = CurrentRect.Overlap(PortalRect);
+			}
+
+			if (FBox2D* Known = NodeViewRects.Find(Neighbour)) {
+				if (ContainsRect(*Known, NeighbourRect)) {
+					continue;
+				}
+				*Known += NeighbourRect;
+			}
+			else {
+				NodeViewRects.Add(Neighbour, NeighbourRect);
+			}
+			PortalFrontier.Add(Neighbour);
+		}
+	}
+
+	// Bulk hide everything that was not reached, tables skip pieces already in the right state
+	for (ASpawnRoom* Room : RoomDungeon) {
+		if (Room) {
+			Room->SetRoomHidden(!NodeViewRects.Contains(GetNodeOfActor(Room)));
+		}
+	}
+	for (ASpawnCorridor* Corridor : CorridorDungeon) {
+		if (Corridor) {
+			Corridor->SetCorridorHidden(!NodeViewRects.Contains(GetNodeOfActor(Corridor)));
+		}
+	}
+}
@@ -1,13 +1,55 @@
 #include "Generators/SpawnRoom.h"
 #include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectArray.h"
+#include "Generators/PieceDestructionQueue.h"
+#include "Generators/SpawnDungeon.h"
+#include "Generators/DungeonCollision.h"
+#include "Generators/RoomShapeCache.h"
+#include "Generators/DungeonSampling.h"
+#include "Generators/DungeonMemory.h"
 #include "Utilities/LoggingTool.h"
 
 DEFINE_LOG_CATEGORY(LogSpawnRoom);
 
-int32 ASpawnRoom::RoomCount = 0;
-
 typedef void (ASpawnRoom::* RoomCreationMethod)(FVector, float, int32, int32);
 
+static TAutoConsoleVariable<bool> CVarDungeonGCClusters(
+	TEXT("Dungeon.GCClusters"),
+	false,
+	TEXT("Group the pieces of each settled room into a GC cluster rooted at the room."),
+	ECVF_Default);
+
+namespace {
+	// Where a piece sits in a room, independent of the room size and wall length
+	struct FRoomSlotKey {
+		ERoomPieceCategory Category = ERoomPieceCategory::Wall;
+
+		// Upper wall row and roof
+		bool bDetail = false;
+
+		// Lattice point and facing of walls and entrances, zero for floor and roof
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		EDungeonOrientation Side = EDungeonOrientation::Forward;
+
+		bool operator==(const FRoomSlotKey& Other) const {
+			return Category == Other.Category and bDetail == Other.bDetail and Cell == Other.Cell and Side == Other.Side;
+		}
+
+		friend uint32 GetTypeHash(const FRoomSlotKey& Key) {
+			return HashCombine(GetTypeHash(Key.Cell), (static_cast<uint32>(Key.Category) << 3) | (static_cast<uint32>(Key.bDetail) << 2) | static_cast<uint32>(Key.Side));
+		}
+	};
+
+	// Piece the rebuilt room should have
+	struct FRoomPlannedPiece {
+		FRoomSlotKey Key;
+		UClass* Class = nullptr;
+		FTransform Transform;
+		ERoomPieceFlags Flags = ERoomPieceFlags::None;
+	};
+}
+
 ASpawnRoom::ASpawnRoom(){
 	PrimaryActorTick.bCanEverTick = true;
 	bIsPlayerInRoom = false;
@@ -16,11 +58,27 @@ ASpawnRoom::ASpawnRoom(){
 
 	PlayerActor = nullptr;
 
+	bCollisionOnly = false;
+
+	// Standalone rooms have collision right away, the dungeon spawns distant rooms without
+	bPhysicsActive = true;
+	bTargetPhysicsActive = true;
+	PhysicsCursor = INDEX_NONE;
+
+	// Standalone rooms get a random stream of their own, the dungeon reseeds the rooms it spawns
+	RandomStream.GenerateNewSeed();
+
+	// Standalone rooms are built fully, the dungeon lowers the tier of distant rooms
+	TargetDetailLevel = ERoomDetailLevel::Full;
+	DetailStage = 0;
+	StageFlags = ERoomPieceFlags::None;
+
 	SetParamForwardWalls(static_cast<int32>(FMath::FRandRange(3.f, 12.f)));
 	SetParamRightWalls(static_cast<int32>(FMath::FRandRange(3.f, 12.f)));
 	SetParamWallLength(400.f);
 	SetParamStartLocation(FVector(0.f, 0.f, 0.f));
 	SetParamStartRotation(FRotator(0.f, 0.f, 0.f));
+	RememberBuiltParams();
 
 	// Create and set the root component
 	RootComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("RootComponent"));
@@ -62,8 +120,9 @@ void ASpawnRoom::BeginPlay(){
 	PlayerDetectBox->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 
 	UE_LOG(LogSpawnRoom, Log, TEXT("Room BeginPlay called."));
-	
-	this->SetParamRoomID(RoomCount++);
+
+	// Dedicated servers only need collision, the dungeon may still override this before CreateRoom
+	bCollisionOnly = GetNetMode() == NM_DedicatedServer;
 
 	EntranceProbability = 0.3f;
 }
@@ -71,23 +130,49 @@ void ASpawnRoom::BeginPlay(){
 // Called every frame
 void ASpawnRoom::Tick(float DeltaTime) {
 	Super::Tick(DeltaTime);
+
+	// Pick up pieces published by late stages, e.g. props
+	if (!PendingPieces.IsEmpty()) {
+		CommitPendingPieces();
+	}
 }
 
-// Calculate the dot product of two vectors with optional wall length and height adjustments
-FVector ASpawnRoom::DotProduct(FVector PositioningVector, FVector SymbolVector, float WallLength = 0.f, float WallHeight = 0.f) {
-	return FVector(PositioningVector.X += WallLength * SymbolVector.X, PositioningVector.Y += WallLength * SymbolVector.Y, PositioningVector.Z += WallHeight * SymbolVector.Z);
+// Drain pieces published by generation stages into RoomObjects, planned pieces are spawned here
+int32 ASpawnRoom::CommitPendingPieces() {
+	LLM_SCOPE_BYTAG(DungeonPieces);
+	UWorld* World = GetWorld();
+
+	return PendingPieces.Drain([this, World](const FRoomPieceRecord& Record) {
+		AActor* Piece = Record.Actor;
+		if (!Piece and Record.Class and World) {
+			Piece = DungeonCollision::SpawnPiece(World, Record.Class, Record.Transform, bTargetPhysicsActive);
+		}
+		if (!Piece) {
+			return;
+		}
+
+		PieceTable.AddActor(Piece, Piece->GetClass(), Piece->GetActorTransform(), Record.Category, Record.ExtraFlags);
+
+		switch (Record.Category) {
+		case ERoomPieceCategory::Wall:     RoomObjects.WallObjectAdd(Piece); break;
+		case ERoomPieceCategory::Entrance: RoomObjects.EntranceObjectAdd(Piece); break;
+		case ERoomPieceCategory::Floor:    RoomObjects.FloorObjectAdd(Piece); break;
+		case ERoomPieceCategory::Roof:     RoomObjects.RoofObjectAdd(Piece); break;
+		case ERoomPieceCategory::Prop:     RoomObjects.PropObjectAdd(Piece); break;
+		}
+		});
 }
 
 // Determine if a wall will be an entrance based on a random value
 bool ASpawnRoom::bWillBeEntrance() {
-	return FMath::FRandRange(0.f, 1.0f) <= EntranceProbability;
+	return RandomStream.FRandRange(0.f, 1.0f) <= EntranceProbability;
 }
 
 // Generate an entrance structure for a wall
 FEntranceStruct ASpawnRoom::GenerateEntranceStruct(float NumberOfWalls, TSubclassOf<AActor> EntranceClass, FEntranceStruct EntranceStruct) {
 	if (!EntranceStruct.bWillBeEntrance) {
 		bool bWillBeEntranceValue = bWillBeEntrance();
-		FEntranceStruct Entrance(EntranceClass, bWillBeEntranceValue ? FMath::FRandRange(1, NumberOfWalls - 1) : -1, bWillBeEntranceValue, FVector::ZeroVector, FRotator::ZeroRotator);
+		FEntranceStruct Entrance(EntranceClass, bWillBeEntranceValue ? RandomStream.FRandRange(1, NumberOfWalls - 1) : -1, bWillBeEntranceValue, FVector::ZeroVector, FRotator::ZeroRotator);
 		return Entrance;
 	}
 	return EntranceStruct;
@@ -110,7 +195,13 @@ void ASpawnRoom::CreateFloor(TSubclassOf<AActor> FloorClass, FVector StartLocati
 		return;
 	}
 
-	AActor* SpawnedFloor = World->SpawnActor<AActor>(FloorClass, FVector(FloorWidth * WallLength / 2 - WallLength / 2, FloorLength * WallLength / 2, -20.f) + StartLocation, StartRotation);
+	if (bCollisionOnly) {
+		AddCollisionPiece(DungeonCollision::AddFloorBox(this, StartLocation, StartRotation, FloorWidth, FloorLength, WallLength), ERoomPieceCategory::Floor);
+		return;
+	}
+
+	// Scaled on spawn to cover the room
+	AActor* SpawnedFloor = DungeonCollision::SpawnPiece(World, FloorClass, GetSlabTransform(StartLocation, StartRotation, FloorWidth, FloorLength, WallLength, -20.f), bTargetPhysicsActive);
 	if (!SpawnedFloor) {
 		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [=]() {
 			ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Oopsie something went wrong. Couldn't create floor!")));
@@ -118,11 +209,12 @@ void ASpawnRoom::CreateFloor(TSubclassOf<AActor> FloorClass, FVector StartLocati
 		return;
 	}
 
-	SpawnedFloor->SetActorScale3D(FVector(static_cast<float>(FloorWidth), static_cast<float>(FloorLength), 1.f)); //Adjusting Floor scale
+	// Published here, committed into RoomObjects on the game thread
+	PendingPieces.Publish(SpawnedFloor, ERoomPieceCategory::Floor, StageFlags);
 
-	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, SpawnedFloor]() {
-		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room Floor created at location: %s"), *SpawnedFloor->GetActorLocation().ToString()));
-		RoomObjects.FloorObjectAdd(SpawnedFloor);
+	FVector FloorLocation = SpawnedFloor->GetActorLocation();
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [FloorLocation]() {
+		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room Floor created at location: %s"), *FloorLocation.ToString()));
 		});
 }
 
@@ -133,7 +225,8 @@ void ASpawnRoom::CreateRoof(TSubclassOf<AActor> RoofClass, FVector StartLocation
 		return;
 	}
 
-	AActor* SpawnedRoof = World->SpawnActor<AActor>(RoofClass, FVector(RoofWidth * WallLength / 2 - WallLength / 2, RoofLength * WallLength / 2, 880.f) + StartLocation, StartRotation);
+	// Scaled on spawn to cover the room
+	AActor* SpawnedRoof = DungeonCollision::SpawnPiece(World, RoofClass, GetSlabTransform(StartLocation, StartRotation, RoofWidth, RoofLength, WallLength, 880.f), bTargetPhysicsActive);
 	if (!SpawnedRoof) {
 		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [=]() {
 			ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Oopsie smothing went wrong. Couldn't create roof!")));
@@ -141,50 +234,82 @@ void ASpawnRoom::CreateRoof(TSubclassOf<AActor> RoofClass, FVector StartLocation
 		return;
 	}
 
-	SpawnedRoof->SetActorScale3D(FVector(static_cast<float>(RoofWidth), static_cast<float>(RoofLength), 1.f)); //Adjusting Roof scale
+	// Published here, committed into RoomObjects on the game thread
+	PendingPieces.Publish(SpawnedRoof, ERoomPieceCategory::Roof, StageFlags);
 
-	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, SpawnedRoof]() {
-		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room Roof created at location: %s"), *SpawnedRoof->GetActorLocation().ToString()));
-		RoomObjects.RoofObjectAdd(SpawnedRoof);
+	FVector RoofLocation = SpawnedRoof->GetActorLocation();
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [RoofLocation]() {
+		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room Roof created at location: %s"), *RoofLocation.ToString()));
 		});
 }
 
-FVector ASpawnRoom::GenerateWalls(UWorld* World, TSubclassOf<AActor> WallClass, FVector StartLocation, FRotator StartRotation, int32 NumberOfWalls, float WallLength, float GapBetweenWalls, FEntranceStruct EntranceObject, TSubclassOf<AActor> WallClassLightned) {
-	for (int32 WallIndex = 0; WallIndex < NumberOfWalls; WallIndex++) {
-		// Determine if we should spawn an entrance
-		bool bIsEntrance = EntranceObject.bWillBeEntrance and (EntranceObject.EntranceID == WallIndex or (EntranceObject.EntrancePosition == StartLocation and EntranceObject.EntrancePosition != FVector::ZeroVector)) and EntranceObject.EntranceClass != nullptr;
+// Floor and roof share the same footprint, only the height differs
+FTransform ASpawnRoom::GetSlabTransform(FVector StartLocation, FRotator StartRotation, int32 Width, int32 Length, float WallLength, float Height) const {
+	const FVector SlabLocation = FVector(Width * WallLength / 2 - WallLength / 2, Length * WallLength / 2, Height) + StartLocation;
+	return FTransform(StartRotation, SlabLocation, FVector(static_cast<float>(Width), static_cast<float>(Length), 1.f));
+}
+
+// Spawn the walls and entrances of a shape template, world transforms are produced here
+void ASpawnRoom::SpawnShape(UWorld* World, const FRoomShapeTemplate& Shape, const FRoomShapeEntrances& Entrances, TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLightned, const TSubclassOf<AActor> (&EntranceClasses)[4], FVector Origin, FRotator OriginRotation, float GridUnit) {
+	for (const FRoomShapePiece& Piece : Shape.Pieces) {
+		const FVector WallLocation = DungeonGrid::ToWorldLocation(Origin, OriginRotation, Piece.Cell, GridUnit);
+		const FRotator WallRotation = DungeonGrid::ToWorldRotation(OriginRotation, Piece.Side);
+		const bool bIsEntrance = Entrances.IsEntrance(Piece);
+		const ERoomPieceCategory Category = bIsEntrance ? ERoomPieceCategory::Entrance : Piece.Category;
+		const bool bLightSlot = !bIsEntrance and EnumHasAnyFlags(Piece.Flags, ERoomPieceFlags::LightSlot);
+
+		// Server profile: full height wall boxes and doorway volumes instead of blueprints
+		if (bCollisionOnly) {
+			if (bIsEntrance) {
+				PendingPieces.Publish(DungeonCollision::SpawnEntranceVolume(World, WallLocation, WallRotation, GridUnit, CollisionShellHeight), ERoomPieceCategory::Entrance);
+			}
+			else {
+				AddCollisionPiece(DungeonCollision::AddWallBox(this, WallLocation, WallRotation, GridUnit, CollisionShellHeight), ERoomPieceCategory::Wall);
+			}
+			continue;
+		}
 
 		// Determine if we should spawn a lightened wall
-		bool bIsLightenedWall = WallIndex % 3 == 0 and WallClassLightned != nullptr;
+		const bool bIsLightenedWall = bLightSlot and WallClassLightned != nullptr;
 
 		// Select the class to spawn based on conditions
-		UClass* ClassToSpawn = bIsEntrance ? EntranceObject.EntranceClass : bIsLightenedWall ? WallClassLightned : WallClass;
+		UClass* ClassToSpawn = bIsEntrance ? EntranceClasses[DungeonGrid::Index(Piece.Side)].Get() : bIsLightenedWall ? WallClassLightned.Get() : WallClass.Get();
 
 		// Spawn the selected actor class
-		AActor* SpawnedWall = World->SpawnActor<AActor>(ClassToSpawn, StartLocation, StartRotation);
-
-		// Add to the appropriate list
-		ClassToSpawn == EntranceObject.EntranceClass ? RoomObjects.EntranceObjectAdd(SpawnedWall) : RoomObjects.WallObjectAdd(SpawnedWall);
+		AActor* SpawnedWall = DungeonCollision::SpawnPiece(World, ClassToSpawn, FTransform(WallRotation, WallLocation), bTargetPhysicsActive);
 
-		// Determine the direction for the next wall placement
-		FVector Direction = (abs(StartRotation.Roll) == 180 && abs(StartRotation.Roll / WallIndex) == 0) ? StartRotation.Vector() : FRotationMatrix(StartRotation).GetScaledAxis(EAxis::X);
+		// Lower walls remember where the lighted variant goes, so detail changes can swap it in and out
+		ERoomPieceFlags PieceFlags = StageFlags & ~ERoomPieceFlags::LightSlot;
+		if (bLightSlot and EnumHasAnyFlags(StageFlags, ERoomPieceFlags::LightSlot)) {
+			PieceFlags |= ERoomPieceFlags::LightSlot;
+		}
 
-		// Update the start location for the next wall
-		StartLocation += (WallLength + GapBetweenWalls) * Direction;
+		// Publish to the appropriate list
+		PendingPieces.Publish(SpawnedWall, Category, PieceFlags);
 	}
-
-	return StartLocation;
 }
 
+// Wall index an entrance struct opens on a side, INDEX_NONE when the side stays closed
+int32 ASpawnRoom::ResolveEntranceIndex(const FEntranceStruct& EntranceObject, EDungeonOrientation Side, int32 NumberOfWallsForward, int32 NumberOfWallsRight, FVector Origin, FRotator OriginRotation, float GridUnit) const {
+	if (!EntranceObject.bWillBeEntrance or (EntranceObject.EntranceClass == nullptr and !bCollisionOnly)) {
+		return INDEX_NONE;
+	}
 
-// Create a segment of the wall with optional entrances
-FVector ASpawnRoom::CreateWallSegment(TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLightned, FEntranceStruct& EntranceObject, FVector StartLocation, FRotator StartRotation, int32 NumberOfWalls, float WallLength, float GapBetweenWalls) {
-	UWorld* World = GetWorld();
-	if (!World) {
-		return FVector::ZeroVector;
+	const int32 NumberOfWalls = DungeonGrid::WallsOnSide(Side, NumberOfWallsForward, NumberOfWallsRight);
+	if (EntranceObject.EntranceID >= 0 and EntranceObject.EntranceID < NumberOfWalls) {
+		return EntranceObject.EntranceID;
 	}
 
-	return GenerateWalls(World, WallClass, StartLocation, StartRotation, NumberOfWalls, WallLength, GapBetweenWalls, EntranceObject, WallClassLightned);
+	// Entrances placed by position instead of index
+	if (EntranceObject.EntrancePosition != FVector::ZeroVector) {
+		const FIntPoint SideStart = DungeonGrid::GetSideStart(Side, NumberOfWallsForward, NumberOfWallsRight);
+		for (int32 WallIndex = 0; WallIndex < NumberOfWalls; WallIndex++) {
+			if (EntranceObject.EntrancePosition.Equals(DungeonGrid::ToWorldLocation(Origin, OriginRotation, DungeonGrid::GetWallPoint(Side, SideStart, WallIndex), GridUnit), 1.f)) {
+				return WallIndex;
+			}
+		}
+	}
+	return INDEX_NONE;
 }
 
 // Create the walls of the room
@@ -194,31 +319,62 @@ void ASpawnRoom::CreateWall(TSubclassOf<AActor> WallClass, TSubclassOf<AActor> W
 		return;
 	}
 
-	FVector DotProductVector[] = { FVector(1.f, 1.f, 0.f), FVector(-0.5f, 0.5f, 0.f), FVector(-0.5f, -0.5f, 0.f), FVector(0.5f, -0.5f, 0.f) };
+	// One lattice step is half a wall plus half a gap
+	const float GridUnit = WallLength + GapBetweenWalls;
 
-	for (int32 WallSide = 0; WallSide < 4; WallSide++) {
-		bool IsEntranceInThisPlane = false;
+	// Side the entrance we came through faces, the rotation is a quarter turn within a degree
+	EDungeonOrientation EntranceSide;
+	const bool bHasEntranceSide = DungeonGrid::TryFromYaw(EntranceObject.EntranceRotation.Yaw, EntranceSide);
 
-		// FMath::IsNearlyEqual needs to check if the angle is -1 or +1 diff
-		if (FMath::IsNearlyEqual(EntranceObject.EntranceRotation.Yaw, WallSide * 90.f, 1.f) or (FMath::IsNearlyEqual(EntranceObject.EntranceRotation.Yaw, -90.f, 1.f) and WallSide == 3) and EntranceObject.EntranceRotation != FRotator::ZeroRotator) {
-			ULoggingTool::LogDebugMessage(FString::Printf(TEXT("New entrance generated for plane %d %s"), EntranceObject.EntranceID, *EntranceObject.EntrancePosition.ToString()));
+	// The shape cache holds the layout for the dimensions and the incoming entrance, the other sides roll per room
+	FRoomShapeKey ShapeKey;
+	FRoomShapeEntrances Entrances;
+	ShapeKey.ForwardWalls = NumberOfWallsForward;
+	ShapeKey.RightWalls = NumberOfWallsRight;
+	TSubclassOf<AActor> EntranceClasses[4];
 
-			EntranceObject.EntranceClass = DefaultEntranceClass;
+	for (int32 SideIndex = 0; SideIndex < 4; SideIndex++) {
+		const EDungeonOrientation Side = static_cast<EDungeonOrientation>(SideIndex);
 
-			StartLocation = CreateWallSegment(WallClass, WallClassLightned, EntranceObject, DotProduct(StartLocation, DotProductVector[WallSide], WallSide == 0 ? 0.f : WallLength), StartRotation + FRotator(0.f, 90.f * WallSide, 0.f), WallSide % 2 == 0 ? NumberOfWallsForward : NumberOfWallsRight, WallLength, GapBetweenWalls);
+		// A rebuild keeps the entrances the room already had, the corridors stay attached to them
+		if (RebuildEntrances) {
+			Entrances.Indices[SideIndex] = RebuildEntrances->Indices[SideIndex];
+			EntranceClasses[SideIndex] = EntranceClass;
+			continue;
 		}
-		else {
-			FEntranceStruct EntranceStruct = GenerateEntranceStruct(WallSide % 2 == 0 ? NumberOfWallsForward : NumberOfWallsRight, EntranceClass, FEntranceStruct());
 
-			StartLocation = CreateWallSegment(WallClass, WallClassLightned, EntranceStruct, DotProduct(StartLocation, DotProductVector[WallSide], WallSide == 0 ? 0.f : WallLength), StartRotation + FRotator(0.f, 90.f * WallSide, 0.f), WallSide % 2 == 0 ? NumberOfWallsForward : NumberOfWallsRight, WallLength, GapBetweenWalls);
+		FEntranceStruct SideEntrance;
+		if (bHasEntranceSide and EntranceSide == Side) {
+			ULoggingTool::LogDebugMessage(FString::Printf(TEXT("New entrance generated for plane %d %s"), EntranceObject.EntranceID, *EntranceObject.EntrancePosition.ToString()));
+
+			SideEntrance = EntranceObject;
+			SideEntrance.EntranceClass = DefaultEntranceClass;
+		}
+		else {
+			SideEntrance = GenerateEntranceStruct(DungeonGrid::WallsOnSide(Side, NumberOfWallsForward, NumberOfWallsRight), EntranceClass, FEntranceStruct());
 		}
 
-		ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Wall segment created at location: %s"), *StartLocation.ToString()));
+		const int32 EntranceIndex = ResolveEntranceIndex(SideEntrance, Side, NumberOfWallsForward, NumberOfWallsRight, StartLocation, StartRotation, GridUnit);
+		if (bHasEntranceSide and EntranceSide == Side) {
+			ShapeKey.EntranceSide = EntranceIndex != INDEX_NONE ? SideIndex : INDEX_NONE;
+			ShapeKey.EntranceIndex = EntranceIndex;
+		}
+		else {
+			Entrances.Indices[SideIndex] = EntranceIndex;
+		}
+		EntranceClasses[SideIndex] = SideEntrance.EntranceClass;
 	}
+
+	const TSharedRef<const FRoomShapeTemplate> Shape = FRoomShapeCache::Get().FindOrBuild(ShapeKey);
+	SpawnShape(World, *Shape, Entrances, WallClass, WallClassLightned, EntranceClasses, StartLocation, StartRotation, GridUnit);
+
+	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Walls created from shape %dx%d, %d pieces"), NumberOfWallsForward, NumberOfWallsRight, Shape->Pieces.Num()));
 }
 
 // Init Assets to build room
 void ASpawnRoom::InitAssets() {
+	LLM_SCOPE_BYTAG(DungeonAssets);
+
 	// Lambda function to load asset classes based on the asset name
 	auto LoadAssetClass = [this](const FString& AssetName) -> TSubclassOf<AActor> {
 		FString Directory;
@@ -265,17 +421,45 @@ void ASpawnRoom::InitAssets() {
 
 // Create whole room method
 void ASpawnRoom::CreateRoom(FEntranceStruct EntranceInfo){
+	LLM_SCOPE_BYTAG(DungeonPieces);
 	ULoggingTool::LogDebugMessage(TEXT("Creating room..."));
 	// Assign room tag
 	if (RoomTag.IsEmpty()) {
 		AssignRoomTag("JSON/RoomTags.json");
 	}
-	AssignRoomAssets("JSON/RoomAssets.json");
-	InitAssets();
-	CreateFloor(DefaultFloorClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
-	CreateWall(DefaultWallClass, DefaultWallClassLightned, DefaultEntranceClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, 0.f, EntranceInfo);
-	CreateWall(DefaultWallClass, nullptr, nullptr, ParamStartLocation + FVector(0.f, 0.f, 450.f), ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, 0.f); //Create upper walls without Lighting assets
-	CreateRoof(DefaultRoofClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
+	DetailStage = 0;
+
+	// Server profile: floor, wall and doorway collision only, room assets are never loaded
+	if (bCollisionOnly) {
+		CreateFloor(nullptr, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
+		CreateWall(nullptr, nullptr, nullptr, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, 0.f, EntranceInfo);
+	}
+	else {
+		AssignRoomAssets("JSON/RoomAssets.json");
+		InitAssets();
+		CreateFloor(DefaultFloorClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
+
+		// Proxy tier is the floor and the outer shell with entrances, without lights, upper walls and roof
+		const bool bFullDetail = TargetDetailLevel == ERoomDetailLevel::Full;
+		StageFlags = ERoomPieceFlags::LightSlot;
+		CreateWall(DefaultWallClass, bFullDetail ? DefaultWallClassLightned : nullptr, DefaultEntranceClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, 0.f, EntranceInfo);
+		StageFlags = ERoomPieceFlags::None;
+
+		// Full detail stages run back to back here, distant rooms get them later one at a time.
+		// Lower walls already use the lighted variant, so the light stage has nothing left to do
+		if (bFullDetail) {
+			ApplyDetailStage(1, true);
+			ApplyDetailStage(2, true);
+			DetailStage = FullDetailStage;
+		}
+	}
+
+	// Everything spawned so far becomes visible to readers of RoomObjects
+	CommitPendingPieces();
+	RememberBuiltParams();
+	if (!NeedsDetailStep()) {
+		CreatePieceCluster();
+	}
 	ULoggingTool::LogDebugMessage(TEXT("Room created successfully."), FColor::Green);
 	ULoggingTool::LogDebugMessage(TEXT("Attaching detection component..."));
 	CreatePlayerDetector();
@@ -283,6 +467,181 @@ void ASpawnRoom::CreateRoom(FEntranceStruct EntranceInfo){
 
 }
 
+// Rebuild the room for its current parameters. Pieces are matched by category, lattice cell and side,
+// matches are moved in place, leftovers are moved into new slots first and only then destroyed or spawned
+void ASpawnRoom::RebuildRoom() {
+	LLM_SCOPE_BYTAG(DungeonPieces);
+	UWorld* World = GetWorld();
+	if (!World) {
+		return;
+	}
+
+	CommitPendingPieces();
+	DissolvePieceCluster();
+
+	// Nothing to diff against yet
+	if (PieceTable.Num() == 0) {
+		DestroyRoom();
+		CreateRoom();
+		return;
+	}
+
+	// Slots of the committed pieces, recovered from their transforms and the parameters they were built with
+	const int32 ExistingCount = PieceTable.Num();
+	TArray<FRoomSlotKey> ExistingKeys;
+	ExistingKeys.Reserve(ExistingCount);
+	for (int32 PieceIndex = 0; PieceIndex < ExistingCount; PieceIndex++) {
+		const ERoomPieceFlags Flags = PieceTable.GetFlags()[PieceIndex];
+		FRoomSlotKey& Key = ExistingKeys.AddDefaulted_GetRef();
+		Key.Category = ToPieceCategory(Flags);
+		Key.bDetail = EnumHasAnyFlags(Flags, ERoomPieceFlags::Detail);
+		if (EnumHasAnyFlags(Flags, ERoomPieceFlags::Wall | ERoomPieceFlags::Entrance)) {
+			const FTransform& Transform = PieceTable.GetTransforms()[PieceIndex];
+			Key.Cell = DungeonGrid::ToLatticePoint(BuiltStartLocation, BuiltStartRotation, Transform.GetLocation(), BuiltWallLength);
+			Key.Side = DungeonGrid::FromYaw(Transform.Rotator().Yaw - BuiltStartRotation.Yaw);
+		}
+	}
+
+	// Entrances stay on the wall they were on, clamped to the new side length, and are cut into the plain shape
+	FRoomShapeKey ShapeKey;
+	ShapeKey.ForwardWalls = ParamForwardWalls;
+	ShapeKey.RightWalls = ParamRightWalls;
+	FRoomShapeEntrances Entrances;
+	const FRoomShapeEntrances NoEntrances;
+
+	for (const FRoomSlotKey& Key : ExistingKeys) {
+		if (Key.Category == ERoomPieceCategory::Entrance and !Key.bDetail) {
+			const int32 WallIndex = DungeonGrid::GetWallIndex(Key.Side, DungeonGrid::GetSideStart(Key.Side, BuiltForwardWalls, BuiltRightWalls), Key.Cell);
+			Entrances.Indices[DungeonGrid::Index(Key.Side)] = FMath::Clamp(WallIndex, 0, DungeonGrid::WallsOnSide(Key.Side, ParamForwardWalls, ParamRightWalls) - 1);
+		}
+	}
+
+	// Collision boxes are cheap enough to rebuild whole, only the entrances have to survive
+	if (bCollisionOnly) {
+		RebuildEntrances = &Entrances;
+		DestroyRoom();
+		CreateRoom();
+		RebuildEntrances = nullptr;
+		return;
+	}
+
+	// Piece list of the new parameters at the current detail stage
+	TArray<FRoomPlannedPiece> Planned;
+	UClass* LightSlotClass = DetailStage == FullDetailStage and DefaultWallClassLightned != nullptr ? DefaultWallClassLightned.Get() : DefaultWallClass.Get();
+
+	auto PlanShape = [this, &Planned](const FRoomShapeTemplate& Shape, const FRoomShapeEntrances& ShapeEntrances, FVector Origin, bool bUpperRow, UClass* SlotClass) {
+		for (const FRoomShapePiece& Piece : Shape.Pieces) {
+			const bool bIsEntrance = ShapeEntrances.IsEntrance(Piece);
+			const bool bLightSlot = !bUpperRow and !bIsEntrance and EnumHasAnyFlags(Piece.Flags, ERoomPieceFlags::LightSlot);
+
+			FRoomPlannedPiece& Plan = Planned.AddDefaulted_GetRef();
+			Plan.Key = { bIsEntrance ? ERoomPieceCategory::Entrance : Piece.Category, bUpperRow, Piece.Cell, Piece.Side };
+			Plan.Class = bIsEntrance ? DefaultEntranceClass.Get() : bLightSlot ? SlotClass : DefaultWallClass.Get();
+			Plan.Transform = FTransform(DungeonGrid::ToWorldRotation(ParamStartRotation, Piece.Side), DungeonGrid::ToWorldLocation(Origin, ParamStartRotation, Piece.Cell, ParamWallLength));
+			Plan.Flags = bUpperRow ? ERoomPieceFlags::Detail : bLightSlot ? ERoomPieceFlags::LightSlot : ERoomPieceFlags::None;
+		}
+		};
+
+	auto PlanSlab = [this, &Planned](ERoomPieceCategory Category, UClass* Class, float Height, ERoomPieceFlags Flags) {
+		FRoomPlannedPiece& Plan = Planned.AddDefaulted_GetRef();
+		Plan.Key.Category = Category;
+		Plan.Key.bDetail = EnumHasAnyFlags(Flags, ERoomPieceFlags::Detail);
+		Plan.Class = Class;
+		Plan.Transform = GetSlabTransform(ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, Height);
+		Plan.Flags = Flags;
+		};
+
+	PlanSlab(ERoomPieceCategory::Floor, DefaultFloorClass.Get(), -20.f, ERoomPieceFlags::None);
+	const TSharedRef<const FRoomShapeTemplate> Shape = FRoomShapeCache::Get().FindOrBuild(ShapeKey);
+	PlanShape(*Shape, Entrances, ParamStartLocation, false, LightSlotClass);
+	if (DetailStage >= 1) {
+		PlanShape(*Shape, NoEntrances, ParamStartLocation + FVector(0.f, 0.f, 450.f), true, nullptr);
+	}
+	if (DetailStage >= 2) {
+		PlanSlab(ERoomPieceCategory::Roof, DefaultRoofClass.Get(), 880.f, ERoomPieceFlags::Detail);
+	}
+
+	TMap<FRoomSlotKey, int32> ExistingBySlot;
+	ExistingBySlot.Reserve(ExistingCount);
+	TBitArray<> Claimed(false, ExistingCount);
+	for (int32 PieceIndex = 0; PieceIndex < ExistingCount; PieceIndex++) {
+		// Props belong to the deco pass, a rebuild leaves them alone
+		if (ExistingKeys[PieceIndex].Category == ERoomPieceCategory::Prop) {
+			Claimed[PieceIndex] = true;
+			continue;
+		}
+		ExistingBySlot.Add(ExistingKeys[PieceIndex], PieceIndex);
+	}
+
+	// Same slot and class: keep the actor, move it only when the wall length or origin changed
+	int32 Moved = 0;
+	TArray<int32> Unmatched;
+	for (int32 PlanIndex = 0; PlanIndex < Planned.Num(); PlanIndex++) {
+		const FRoomPlannedPiece& Plan = Planned[PlanIndex];
+		const int32* Found = ExistingBySlot.Find(Plan.Key);
+		if (Found and !Claimed[*Found] and PieceTable.GetClass(*Found) == Plan.Class) {
+			Claimed[*Found] = true;
+			Moved += PieceTable.MovePiece(*Found, Plan.Transform, Plan.Flags) ? 1 : 0;
+			continue;
+		}
+		Unmatched.Add(PlanIndex);
+	}
+
+	// Slots that appeared reuse actors of the same kind whose slot disappeared
+	TArray<int32> ToSpawn;
+	for (int32 PlanIndex : Unmatched) {
+		const FRoomPlannedPiece& Plan = Planned[PlanIndex];
+		int32 Reused = INDEX_NONE;
+		for (int32 PieceIndex = 0; PieceIndex < ExistingCount; PieceIndex++) {
+			if (!Claimed[PieceIndex] and ExistingKeys[PieceIndex].Category == Plan.Key.Category and ExistingKeys[PieceIndex].bDetail == Plan.Key.bDetail and PieceTable.GetClass(PieceIndex) == Plan.Class) {
+				Reused = PieceIndex;
+				break;
+			}
+		}
+
+		if (Reused == INDEX_NONE) {
+			ToSpawn.Add(PlanIndex);
+			continue;
+		}
+		Claimed[Reused] = true;
+		PieceTable.MovePiece(Reused, Plan.Transform, Plan.Flags);
+		Moved++;
+	}
+
+	// Whatever is left has no slot in the new layout
+	RemovePieces([&Claimed](int32 PieceIndex) { return !Claimed[PieceIndex]; });
+	const int32 Destroyed = ExistingCount - PieceTable.Num();
+
+	for (int32 PlanIndex : ToSpawn) {
+		const FRoomPlannedPiece& Plan = Planned[PlanIndex];
+		PendingPieces.PublishPlanned(Plan.Class, Plan.Transform, Plan.Key.Category, Plan.Flags);
+	}
+	const int32 Spawned = CommitPendingPieces();
+
+	RememberBuiltParams();
+	CreatePlayerDetector();
+	if (!NeedsDetailStep()) {
+		CreatePieceCluster();
+	}
+
+	UE_LOG(LogSpawnRoom, Log, TEXT("Room %d rebuilt as %dx%d: %d spawned, %d moved, %d destroyed, %d pieces"), RoomID, ParamForwardWalls, ParamRightWalls, Spawned, Moved, Destroyed, PieceTable.Num());
+}
+
+// Snapshot of the parameters the current pieces match
+void ASpawnRoom::RememberBuiltParams() {
+	BuiltForwardWalls = ParamForwardWalls;
+	BuiltRightWalls = ParamRightWalls;
+	BuiltWallLength = ParamWallLength;
+	BuiltStartLocation = ParamStartLocation;
+	BuiltStartRotation = ParamStartRotation;
+}
+
+// Method to get the queue of the owning dungeon, nullptr once the dungeon is gone
+FPieceDestructionQueue* ASpawnRoom::GetDestructionQueue() const {
+	ASpawnDungeon* Dungeon = OwningDungeon.Get();
+	return Dungeon ? &Dungeon->GetDestructionQueue() : nullptr;
+}
+
 // Destroy room and emptying room elements
 void ASpawnRoom::DestroyRoom() {
 	UWorld* World = GetWorld();
@@ -290,43 +649,224 @@ void ASpawnRoom::DestroyRoom() {
 		return;
 	}
 
-	// Creating lambda function to destory actors
-	auto SafeDestroyActor = [](AActor* Actor) {
-		if (Actor) {
-			AsyncTask(ENamedThreads::GameThread, [Actor]() {
-				if (Actor) {
-					//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Actor Destroyed %s"), *Actor->GetName()));
-					Actor->Destroy();
-					UE_LOG(LogSpawnRoom, Log, TEXT("Destroyed actor: %s"), *Actor->GetName());
-				}
+	// Pieces still in flight belong to the room as well, and none of them may stay pinned by the cluster
+	CommitPendingPieces();
+	DissolvePieceCluster();
+
+	// Pieces go to the dungeon queue which destroys them in batches, standalone rooms destroy in place
+	const int32 Removed = PieceTable.DestroyPieces(ERoomPieceFlags::AllCategories, GetDestructionQueue());
+	DungeonCollision::DestroyBoxes(CollisionBoxes);
+
+	RoomObjects.WallObject.Empty();
+	RoomObjects.EntranceObject.Empty();
+	RoomObjects.FloorObject.Empty();
+	RoomObjects.RoofObject.Empty();
+	RoomObjects.PropObject.Empty();
+
+	UE_LOG(LogSpawnRoom, Log, TEXT("Room %d removed %d pieces"), RoomID, Removed);
+}
+
+// Advance one detail stage towards the target tier, returns true while more stages are pending
+bool ASpawnRoom::StepDetailLevel() {
+	const int32 TargetStage = TargetDetailLevel == ERoomDetailLevel::Full ? FullDetailStage : 0;
+	if (DetailStage == TargetStage) {
+		return false;
+	}
+
+	// Stages work on the piece table, so it has to be up to date
+	LLM_SCOPE_BYTAG(DungeonPieces);
+	CommitPendingPieces();
+	DissolvePieceCluster();
+
+	if (DetailStage < TargetStage) {
+		ApplyDetailStage(++DetailStage, true);
+	}
+	else {
+		ApplyDetailStage(DetailStage--, false);
+	}
+
+	CommitPendingPieces();
+	if (DetailStage == TargetStage) {
+		CreatePieceCluster();
+	}
+	return DetailStage != TargetStage;
+}
+
+// Add or remove the pieces of a single full detail stage
+void ASpawnRoom::ApplyDetailStage(int32 Stage, bool bAdd) {
+	switch (Stage) {
+	case 1: // Upper walls, never lighted
+		if (bAdd) {
+			StageFlags = ERoomPieceFlags::Detail;
+			CreateWall(DefaultWallClass, nullptr, nullptr, ParamStartLocation + FVector(0.f, 0.f, 450.f), ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength, 0.f); //Create upper walls without Lighting assets
+			StageFlags = ERoomPieceFlags::None;
+		}
+		else {
+			RemovePieces([this](int32 PieceIndex) {
+				const ERoomPieceFlags Flags = PieceTable.GetFlags()[PieceIndex];
+				return EnumHasAllFlags(Flags, ERoomPieceFlags::Detail) and EnumHasAnyFlags(Flags, ERoomPieceFlags::Wall | ERoomPieceFlags::Entrance);
 				});
 		}
-		};
+		break;
+	case 2: // Roof
+		if (bAdd) {
+			StageFlags = ERoomPieceFlags::Detail;
+			CreateRoof(DefaultRoofClass, ParamStartLocation, ParamStartRotation, ParamForwardWalls, ParamRightWalls, ParamWallLength);
+			StageFlags = ERoomPieceFlags::None;
+		}
+		else {
+			RemovePieces([this](int32 PieceIndex) { return EnumHasAllFlags(PieceTable.GetFlags()[PieceIndex], ERoomPieceFlags::Detail | ERoomPieceFlags::Roof); });
+		}
+		break;
+	case 3: // Lighted wall variants
+		SwapLightSlots(bAdd ? DefaultWallClassLightned : DefaultWallClass);
+		break;
+	default:
+		break;
+	}
+}
 
-	for (AActor* Wall : RoomObjects.WallObject) {
-		SafeDestroyActor(Wall);
+// Replace every light slot wall that does not use NewClass yet
+void ASpawnRoom::SwapLightSlots(UClass* NewClass) {
+	if (!NewClass) {
+		return;
 	}
-	RoomObjects.WallObject.Empty(); // Emptying array
 
-	for (AActor* Entrance : RoomObjects.EntranceObject) {
-		SafeDestroyActor(Entrance);
+	TArray<FTransform> SlotTransforms;
+	RemovePieces([this, NewClass, &SlotTransforms](int32 PieceIndex) {
+		if (!EnumHasAnyFlags(PieceTable.GetFlags()[PieceIndex], ERoomPieceFlags::LightSlot) or PieceTable.GetClass(PieceIndex) == NewClass) {
+			return false;
+		}
+		SlotTransforms.Add(PieceTable.GetTransforms()[PieceIndex]);
+		return true;
+		});
+
+	// Spawned at the next commit
+	for (const FTransform& SlotTransform : SlotTransforms) {
+		PendingPieces.PublishPlanned(NewClass, SlotTransform, ERoomPieceCategory::Wall, ERoomPieceFlags::LightSlot);
 	}
-	RoomObjects.EntranceObject.Empty();
+}
 
-	for (AActor* Floor : RoomObjects.FloorObject) {
-		SafeDestroyActor(Floor);
+// Remove pieces from the table and from RoomObjects, actors go to the destruction queue
+void ASpawnRoom::RemovePieces(TFunctionRef<bool(int32 PieceIndex)> Predicate) {
+	TArray<AActor*> Removed;
+	PieceTable.DestroyPiecesWhere(Predicate, GetDestructionQueue(), &Removed);
+	if (Removed.IsEmpty()) {
+		return;
 	}
-	RoomObjects.FloorObject.Empty();
 
-	for (AActor* Roof : RoomObjects.RoofObject) {
-		SafeDestroyActor(Roof);
+	// Compaction moved pieces below the cursor, a pending physics switch starts over. Pieces already switched are skipped cheaply
+	if (NeedsPhysicsStep()) {
+		PhysicsCursor = 0;
 	}
-	RoomObjects.RoofObject.Empty();
 
-	for (AActor* Prop : RoomObjects.PropObject) {
-		SafeDestroyActor(Prop);
+	TSet<AActor*> RemovedSet(Removed);
+	auto IsRemoved = [&RemovedSet](AActor* Actor) { return RemovedSet.Contains(Actor); };
+	RoomObjects.WallObject.RemoveAll(IsRemoved);
+	RoomObjects.EntranceObject.RemoveAll(IsRemoved);
+	RoomObjects.FloorObject.RemoveAll(IsRemoved);
+	RoomObjects.RoofObject.RemoveAll(IsRemoved);
+	RoomObjects.PropObject.RemoveAll(IsRemoved);
+}
+
+// Set the state the room moves towards, an empty room switches at once
+void ASpawnRoom::SetPhysicsActive(bool bActive) {
+	if (bCollisionOnly or bActive == bTargetPhysicsActive) {
+		return;
+	}
+
+	bTargetPhysicsActive = bActive;
+	PhysicsCursor = 0;
+
+	if (PieceTable.Num() == 0 and PendingPieces.IsEmpty()) {
+		StepPhysicsActivation(1);
+	}
+}
+
+// Switch a budget of pieces, the player detector follows once every piece is done
+int32 ASpawnRoom::StepPhysicsActivation(int32 MaxPieces) {
+	if (!NeedsPhysicsStep()) {
+		return 0;
+	}
+
+	CommitPendingPieces();
+	const int32 Touched = PieceTable.SetCollisionEnabled(bTargetPhysicsActive, PhysicsCursor, MaxPieces);
+	if (PhysicsCursor < PieceTable.Num()) {
+		return Touched;
+	}
+
+	SetDetectorActive(bTargetPhysicsActive);
+	bPhysicsActive = bTargetPhysicsActive;
+	PhysicsCursor = INDEX_NONE;
+	UE_LOG(LogSpawnRoom, Verbose, TEXT("Room %d physics %s"), RoomID, bPhysicsActive ? TEXT("active") : TEXT("inactive"));
+	return Touched;
+}
+
+void ASpawnRoom::SetDetectorActive(bool bActive) {
+	PlayerDetectBox->SetGenerateOverlapEvents(bActive);
+	PlayerDetectBox->SetCollisionEnabled(bActive ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+}
+
+// Piece actors and their classes are only held by the piece table
+void ASpawnRoom::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) {
+	CastChecked<ASpawnRoom>(InThis)->PieceTable.AddReferencedObjects(Collector);
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+bool ASpawnRoom::CanBeClusterRoot() const {
+	return CVarDungeonGCClusters.GetValueOnGameThread() and !bCollisionOnly;
+}
+
+// Only piece classes that allow clustering join, the rest stay regular objects referenced by the cluster
+void ASpawnRoom::CreatePieceCluster() {
+	if (!CanBeClusterRoot() or HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot) or PieceTable.Num() == 0) {
+		return;
+	}
+	CreateCluster();
+	UE_LOG(LogSpawnRoom, Verbose, TEXT("Room %d clustered with %d pieces"), RoomID, PieceTable.Num());
+}
+
+void ASpawnRoom::DissolvePieceCluster() {
+	if (HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot)) {
+		GUObjectClusters.DissolveCluster(this);
 	}
-	RoomObjects.PropObject.Empty();
+}
+
+// Pieces, collision boxes and the lists kept for them
+void ASpawnRoom::CollectMemoryStats(FDungeonMemoryStats& OutStats) const {
+	OutStats.Pieces += PieceTable.Num();
+	for (const FRoomPieceHandle& Handle : PieceTable.GetHandles()) {
+		if (Handle.Kind == ERoomPieceHandleKind::Actor) {
+			DungeonMemory::AccumulateActor(Handle.Actor, OutStats);
+		}
+	}
+
+	// The room actor itself carries the detector and the collision boxes
+	DungeonMemory::AccumulateActor(this, OutStats);
+
+	OutStats.ContainerBytes += PieceTable.GetAllocatedSize() + CollisionBoxes.GetAllocatedSize() + RoomAssetData.GetAllocatedSize();
+	OutStats.ContainerBytes += RoomObjects.WallObject.GetAllocatedSize() + RoomObjects.EntranceObject.GetAllocatedSize() + RoomObjects.FloorObject.GetAllocatedSize() + RoomObjects.RoofObject.GetAllocatedSize() + RoomObjects.PropObject.GetAllocatedSize();
+	for (const FAssetStruct& AssetInfo : RoomAssetData) {
+		OutStats.ContainerBytes += AssetInfo.AssetName.GetAllocatedSize() + AssetInfo.Directory.GetAllocatedSize();
+	}
+}
+
+// Register a collision box of the server profile as an instance piece
+void ASpawnRoom::AddCollisionPiece(UBoxComponent* Box, ERoomPieceCategory Category) {
+	if (Box) {
+		PieceTable.AddSlot(CollisionBoxes.Add(Box), ERoomPieceHandleKind::Instance, UBoxComponent::StaticClass(), Box->GetComponentTransform(), Category);
+	}
+}
+
+// Hide or show every piece of the room in one pass over the piece table
+void ASpawnRoom::SetRoomHidden(bool bHidden) {
+	CommitPendingPieces();
+	PieceTable.SetHidden(ERoomPieceFlags::AllCategories, bHidden);
+}
+
+// Bounds of the room computed from piece transforms, half a wall of padding around the origins
+FBox ASpawnRoom::GetRoomBounds() const {
+	return PieceTable.ComputeBounds(ERoomPieceFlags::AllCategories, FVector(ParamWallLength / 2));
 }
 
 // Add to the room BoxComponent to detect if player in room
@@ -340,64 +880,48 @@ void ASpawnRoom::CreatePlayerDetector(){
 
 //Assign tag to room
 void ASpawnRoom::AssignRoomTag(const FString& FilePath) {
+	LLM_SCOPE_BYTAG(DungeonConfig);
+
 	// JSON load object
 	TArray<FRoomCategoryStruct> RoomCategories = URoomTagLoader::LoadRoomTags(FilePath);
 
-	// Create Map to store category probabilities
-	TMap<FString, float> CategoryWeights;
-	float TotalWeights = 0.f;
+	// Weight of a category is the sum of its tag weights
+	TArray<float> CategoryWeights;
+	CategoryWeights.Reserve(RoomCategories.Num());
 	for (const FRoomCategoryStruct& Category : RoomCategories) {
 		float CumulativeWeight = 0.f;
 		for (const FRoomTagStruct& Tag : Category.Tags) {
 			CumulativeWeight += Tag.Weight;
 		}
-		TotalWeights += CumulativeWeight;
-		CategoryWeights.Add(Category.CategoryName, CumulativeWeight);
+		CategoryWeights.Add(CumulativeWeight);
 	}
 
 	// Choose category by the probability
-	float RandomValue = FMath::FRandRange(0.f, TotalWeights);
-	FString ChosenCategory;
-	for (const auto& Elem : CategoryWeights) {
-		RandomValue -= Elem.Value;
-		if (RandomValue <= Elem.Value) {
-			ChosenCategory = Elem.Key;
-			break;
-		}
-	}
-
-	// Find the chosen category in RoomCategories
-	FRoomCategoryStruct* SelectedCategory = RoomCategories.FindByPredicate([&ChosenCategory](const FRoomCategoryStruct& Category) {
-		return Category.CategoryName == ChosenCategory;
-		});
-
-	if (!SelectedCategory) {
-		UE_LOG(LogTemp, Error, TEXT("Failed to find selected category: %s"), *ChosenCategory);
+	const int32 CategoryIndex = DungeonSampling::PickWeighted(RandomStream, CategoryWeights);
+	if (CategoryIndex == INDEX_NONE) {
+		UE_LOG(LogTemp, Error, TEXT("Failed to select a room category from %s"), *FilePath);
 		return;
 	}
+	const FRoomCategoryStruct& SelectedCategory = RoomCategories[CategoryIndex];
 
-	// Create map to store tag probabilities within the chosen category
-	TMap<FString, float> TagWeights;
-	float TotalTagWeights = 0.f;
-	for (const FRoomTagStruct& Tag : SelectedCategory->Tags) {
-		TagWeights.Add(Tag.Name, Tag.Weight);
-		TotalTagWeights += Tag.Weight;
+	// Choose tag by the probability within the chosen category
+	TArray<float> TagWeights;
+	TagWeights.Reserve(SelectedCategory.Tags.Num());
+	for (const FRoomTagStruct& Tag : SelectedCategory.Tags) {
+		TagWeights.Add(Tag.Weight);
 	}
 
-	// Choose tag by the probability within the chosen category
-	RandomValue = FMath::FRandRange(0.f, TotalTagWeights);
-	for (const auto& Elem : TagWeights) {
-		RandomValue -= Elem.Value;
-		if (RandomValue <= 0.f) {
-			RoomTag = Elem.Key;
-			break;
-		}
+	const int32 TagIndex = DungeonSampling::PickWeighted(RandomStream, TagWeights);
+	if (TagIndex != INDEX_NONE) {
+		RoomTag = SelectedCategory.Tags[TagIndex].Name;
 	}
 
 	ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Room Tag for current - ID %d: %s"), RoomID, *RoomTag), FColor::Yellow);
 }
 
 void ASpawnRoom::AssignRoomAssets(const FString& FilePath){
+	LLM_SCOPE_BYTAG(DungeonAssets);
+
 	// Load all room assets
 	FRoomAssetStruct AllRoomAssets = URoomAssetLoader::LoadRoomAsset(FilePath);
 	
@@ -486,12 +1010,12 @@ void ASpawnRoom::CreateSingleProp(UClass* PropClass, FVector StartLocation, FRot
 
 	// Spawn single prop asynchronously
 	AsyncTask(ENamedThreads::GameThread, [this, PropClass, StartLocation, StartRotation, World]() {
-		AActor* SpawnedActor = World->SpawnActor<AActor>(PropClass, StartLocation, StartRotation);
+		AActor* SpawnedActor = DungeonCollision::SpawnPiece(World, PropClass, FTransform(StartRotation, StartLocation), bTargetPhysicsActive);
 		if (!SpawnedActor) {
 			ULoggingTool::LogDebugMessage(TEXT("Failed to spawn prop"), FColor::Red);
 		}
 		else {
-			RoomObjects.PropObjectAdd(SpawnedActor);
+			PendingPieces.Publish(SpawnedActor, ERoomPieceCategory::Prop);
 		}
 		});
 }
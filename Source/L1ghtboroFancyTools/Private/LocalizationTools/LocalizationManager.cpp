@@ -1,5 +1,6 @@
 #include "LocalizationTools/LocalizationManager.h"
 #include "Utilities/JsonLibrary.h"
+#include "Utilities/JsonPathQuery.h"
 #include "Utilities/LoggingTool.h"
 
 void ULocalizationManager::Init(const FString& LanguageCode, const FString& FilePath) {
@@ -17,20 +18,42 @@ bool ULocalizationManager::LoadLocalizationData(const FString& FilePath) {
 
     if (!LocalizationData.IsValid()) {
         ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Failed to load JSON file: %s"), *FilePath), FColor::Red);
+        ResolveLanguageData();
         return false;
     }
 
+    ResolveLanguageData();
     return true;
 }
 
+void ULocalizationManager::LoadLocalizationDataAsync(const FString& FilePath, TUniqueFunction<void(bool bLoaded)> OnLoaded) {
+    TWeakObjectPtr<ULocalizationManager> WeakThis(this);
+    UJsonLibrary::LoadJSONFilesAsync({ FilePath }, [WeakThis, FilePath, OnLoaded = MoveTemp(OnLoaded)](TArray<TSharedPtr<FJsonObject>>&& Objects) {
+        ULocalizationManager* Manager = WeakThis.Get();
+        if (!Manager) {
+            return;
+        }
+
+        Manager->LocalizationData = Objects[0];
+        Manager->ResolveLanguageData();
+
+        const bool bLoaded = Manager->LocalizationData.IsValid();
+        if (!bLoaded) {
+            ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Failed to load JSON file: %s"), *FilePath), FColor::Red);
+        }
+        if (OnLoaded) {
+            OnLoaded(bLoaded);
+        }
+        });
+}
+
 FString ULocalizationManager::GetLocalizedString(const FString& Key) const {
-    if (LocalizationData.IsValid()) {
-        TSharedPtr<FJsonObject> LanguageData;
-        if (UJsonLibrary::GetObjectField(LocalizationData, CurrentLanguage, LanguageData)) {
-            FString LocalizedString;
-            if (UJsonLibrary::GetStringField(LanguageData, Key, LocalizedString)) {
-                return LocalizedString;
-            }
+    if (LanguageData.IsValid()) {
+        // Numbers and bools come back as text, like the lookup did before the data was cached
+        const TSharedPtr<FJsonValue>* Value = LanguageData->Values.Find(Key);
+        FString Localized;
+        if (Value and Value->IsValid() and (*Value)->TryGetString(Localized)) {
+            return Localized;
         }
     }
 
@@ -40,6 +63,7 @@ FString ULocalizationManager::GetLocalizedString(const FString& Key) const {
 
 void ULocalizationManager::SetCurrentLanguage(const FString& LanguageCode) {
     CurrentLanguage = LanguageCode;
+    ResolveLanguageData();
     ULoggingTool::LogDebugMessage(FString::Printf(TEXT("Language set to: %s"), *LanguageCode), FColor::Green);
 }
 
@@ -52,11 +76,17 @@ TArray<FString> ULocalizationManager::GetAvailableLanguages() const {
 }
 
 bool ULocalizationManager::HasKey(const FString& Key) const {
-    if (LocalizationData.IsValid()) {
-        TSharedPtr<FJsonObject> LanguageData;
-        if (UJsonLibrary::GetObjectField(LocalizationData, CurrentLanguage, LanguageData)) {
-            return LanguageData->HasField(Key);
-        }
+    return LanguageData.IsValid() and LanguageData->Values.Contains(Key);
+}
+
+void ULocalizationManager::ResolveLanguageData() {
+    LanguageData.Reset();
+    if (!LocalizationData.IsValid()) {
+        return;
+    }
+
+    const FJsonValue* Language = FJsonPathQuery().AddField(CurrentLanguage).FindFirst(*LocalizationData);
+    if (Language and Language->Type == EJson::Object) {
+        LanguageData = Language->AsObject();
     }
-    return false;
 }
\ No newline at end of file
@@ -0,0 +1,622 @@
+#include "Utilities/JsonBenchCommandlet.h"
+#include "Utilities/JsonPathQuery.h"
+#include "Utilities/JsonStreamReader.h"
+#include "Utilities/JsonStructBinding.h"
+#include "Utilities/JsonTapeDocument.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogJsonBench, Log, All);
+
+namespace {
+    // Forwards to the real allocator and keeps a table of the blocks allocated through it while installed.
+    // Frees of blocks that were allocated before the swap are not in the table and leave the counters alone.
+    // Allocations of other threads still land in the table, the numbers are only clean in an otherwise idle commandlet
+    class FJsonBenchMalloc final : public FMalloc {
+    public:
+        explicit FJsonBenchMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+        // Only while the proxy is not installed, emptying the table frees through GMalloc
+        void ResetCounters() {
+            FScopeLock Lock(&TableLock);
+            LiveBlocks.Empty();
+            Allocations = 0;
+            CurrentBytes = 0;
+            PeakBytes = 0;
+        }
+
+        int64 GetAllocations() const { return Allocations; }
+
+        // Highest number of bytes live at once in blocks allocated through the proxy
+        int64 GetPeakBytes() const { return PeakBytes; }
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override {
+            void* Result = Inner->Malloc(Count, Alignment);
+            Track(Result, Count);
+            return Result;
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override {
+            Untrack(Original);
+            void* Result = Inner->Realloc(Original, Count, Alignment);
+            Track(Result, Count);
+            return Result;
+        }
+
+        virtual void Free(void* Original) override {
+            Untrack(Original);
+            Inner->Free(Original);
+        }
+
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("JsonBench"); }
+
+    private:
+        // The table allocates through GMalloc as well, its own blocks pass through untracked
+        void Track(void* Pointer, SIZE_T Count) {
+            if (!Pointer or bInTable) {
+                return;
+            }
+            TGuardValue<bool> Guard(bInTable, true);
+
+            SIZE_T Size = Count;
+            Inner->GetAllocationSize(Pointer, Size);
+
+            FScopeLock Lock(&TableLock);
+            LiveBlocks.Add(Pointer, Size);
+            Allocations++;
+            CurrentBytes += Size;
+            PeakBytes = FMath::Max(PeakBytes, CurrentBytes);
+        }
+
+        void Untrack(void* Pointer) {
+            if (!Pointer or bInTable) {
+                return;
+            }
+            TGuardValue<bool> Guard(bInTable, true);
+
+            FScopeLock Lock(&TableLock);
+            SIZE_T Size = 0;
+            if (LiveBlocks.RemoveAndCopyValue(Pointer, Size)) {
+                CurrentBytes -= Size;
+            }
+        }
+
+        FMalloc* Inner;
+        FCriticalSection TableLock;
+        TMap<void*, SIZE_T> LiveBlocks;
+        int64 Allocations = 0;
+        int64 CurrentBytes = 0;
+        int64 PeakBytes = 0;
+
+        static inline thread_local bool bInTable = false;
+    };
+
+    // Counts events so the reader has a visitor that does something
+    class FJsonBenchVisitor final : public IJsonVisitor {
+    public:
+        int64 Events = 0;
+
+        virtual EJsonVisit OnKey(FStringView Key) override { Events += Key.Len(); return EJsonVisit::Continue; }
+        virtual EJsonVisit OnString(FStringView Value) override { Events += Value.Len(); return EJsonVisit::Continue; }
+        virtual EJsonVisit OnNumber(double Value) override { Events++; return EJsonVisit::Continue; }
+        virtual EJsonVisit OnBool(bool bValue) override { Events++; return EJsonVisit::Continue; }
+    };
+
+    struct FBenchDocument {
+        FString Name;
+        TArray<uint8> Text;
+        TArray<uint8> Cooked;
+
+        // Path read in the access phase, every match is decoded to a string
+        FString AccessPath;
+        bool bBindRows = false;
+    };
+
+    struct FBenchResult {
+        FString Document;
+        FString Method;
+        FString Phase;
+        int32 Iterations = 0;
+        double Seconds = 0.0;
+        double MBPerSecond = 0.0;
+        int64 Allocations = 0;
+        int64 PeakBytes = 0;
+        int64 Checksum = 0;
+    };
+
+    class FJsonBench {
+    public:
+        explicit FJsonBench(int32 InIterations) : Iterations(InIterations) {}
+
+        TArray<FBenchResult> Results;
+
+        // Throughput is always against the text size, so every method of a document compares on the same bytes.
+        // Body returns a checksum of what it read, it goes into the report and keeps the work observable
+        void Measure(const FBenchDocument& Document, const TCHAR* Method, const TCHAR* Phase, TFunctionRef<int64()> Body) {
+            FBenchResult& Result = Results.AddDefaulted_GetRef();
+            Result.Document = Document.Name;
+            Result.Method = Method;
+            Result.Phase = Phase;
+            Result.Iterations = Iterations;
+
+            // One untimed pass to warm caches, allocators and the struct field maps
+            Result.Checksum = Body();
+
+            const double StartTime = FPlatformTime::Seconds();
+            for (int32 Iteration = 0; Iteration < Iterations; Iteration++) {
+                Result.Checksum += Body();
+            }
+            const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+            // Allocations come from one more pass of their own, so the table kept by the proxy stays out of the timings
+            static FJsonBenchMalloc* BenchMalloc = new FJsonBenchMalloc(GMalloc);
+            BenchMalloc->ResetCounters();
+            FMalloc* PreviousMalloc = static_cast<FMalloc*>(FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), BenchMalloc));
+            Result.Checksum += Body();
+            FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), PreviousMalloc);
+
+            Result.Seconds = Elapsed / Iterations;
+            Result.MBPerSecond = Document.Text.Num() / (1024.0 * 1024.0) / FMath::Max(Result.Seconds, 1e-9);
+            Result.Allocations = BenchMalloc->GetAllocations();
+            Result.PeakBytes = BenchMalloc->GetPeakBytes();
+
+            UE_LOG(LogJsonBench, Display, TEXT("%-14s %-8s %-10s %10.2f MB/s %10.3f ms %10lld allocs %12lld peak bytes"),
+                *Result.Document, Method, Phase, Result.MBPerSecond, Result.Seconds * 1e3, Result.Allocations, Result.PeakBytes);
+        }
+
+        void Run(const FBenchDocument& Document) {
+            const TArrayView<const uint8> Text = Document.Text;
+            const TArrayView<const uint8> Cooked = Document.Cooked;
+            const FJsonPathQuery Query(Document.AccessPath);
+
+            // Dom is the FString path LoadJSONFromFile took before the tape reader, conversion included
+            Measure(Document, TEXT("Dom"), TEXT("Parse"), [Text]() {
+                FString String;
+                FFileHelper::BufferToString(String, Text.GetData(), Text.Num());
+                TSharedPtr<FJsonObject> Object;
+                FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(String), Object);
+                return Object.IsValid() ? static_cast<int64>(Object->Values.Num()) : 0;
+                });
+
+            FString DomString;
+            FFileHelper::BufferToString(DomString, Text.GetData(), Text.Num());
+            TSharedPtr<FJsonObject> DomObject;
+            FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(DomString), DomObject);
+
+            Measure(Document, TEXT("Dom"), TEXT("Access"), [&Query, &DomObject]() {
+                TArray<const FJsonValue*> Values;
+                Query.FindAll(*DomObject, Values);
+                int64 Length = 0;
+                for (const FJsonValue* Value : Values) {
+                    Length += Value->AsString().Len();
+                }
+                return Length;
+                });
+
+            Measure(Document, TEXT("Dom"), TEXT("Serialize"), [&DomObject]() {
+                TArray<uint8> Bytes;
+                FMemoryWriter Writer(Bytes);
+                FJsonSerializer::Serialize(DomObject.ToSharedRef(), TJsonWriterFactory<UTF8CHAR>::Create(&Writer));
+                return static_cast<int64>(Bytes.Num());
+                });
+
+            Measure(Document, TEXT("Stream"), TEXT("Parse"), [Text]() {
+                FJsonBenchVisitor Visitor;
+                FJsonStreamReader Reader(Text);
+                Reader.Read(Visitor);
+                return Visitor.Events;
+                });
+
+            Measure(Document, TEXT("Tape"), TEXT("Parse"), [Text]() {
+                FJsonTapeDocument Tape;
+                Tape.ParseView(Text);
+                return static_cast<int64>(Tape.GetTapeLength());
+                });
+
+            FJsonTapeDocument Tape;
+            Tape.ParseView(Text);
+            Measure(Document, TEXT("Tape"), TEXT("Access"), [&Query, &Tape]() {
+                TArray<FJsonTapeValue> Values;
+                Query.FindAll(Tape.GetRoot(), Values);
+                int64 Length = 0;
+                for (const FJsonTapeValue& Value : Values) {
+                    Length += Value.AsString().Len();
+                }
+                return Length;
+                });
+
+            Measure(Document, TEXT("Cooked"), TEXT("Parse"), [Cooked]() {
+                FJsonTapeDocument CookedTape;
+                CookedTape.ParseView(Cooked);
+                return static_cast<int64>(CookedTape.GetTapeLength());
+                });
+
+            Measure(Document, TEXT("Cooked"), TEXT("Serialize"), [&Tape]() {
+                TArray<uint8> Bytes;
+                Tape.WriteCooked(Bytes);
+                return static_cast<int64>(Bytes.Num());
+                });
+
+            if (Document.bBindRows) {
+                Measure(Document, TEXT("Binding"), TEXT("Parse"), [Text]() {
+                    FJsonTapeDocument RowsTape;
+                    FJsonBenchRows Rows;
+                    if (RowsTape.ParseView(Text)) {
+                        FJsonStructBinding::BindStruct(RowsTape.GetRoot(), Rows);
+                    }
+                    return static_cast<int64>(Rows.Rows.Num());
+                    });
+
+                FJsonBenchRows Rows;
+                FJsonStructBinding::BindStruct(Tape.GetRoot(), Rows);
+                Measure(Document, TEXT("Binding"), TEXT("Access"), [&Rows]() {
+                    int64 Length = 0;
+                    for (const FJsonBenchRow& Row : Rows.Rows) {
+                        Length += Row.Name.Len();
+                    }
+                    return Length;
+                    });
+            }
+        }
+
+    private:
+        int32 Iterations;
+    };
+
+    // Strings carry an escaped quote and a \u sequence now and then, like translated text does
+    FString MakeText(FRandomStream& Stream) {
+        static const TCHAR* Words[] = { TEXT("dungeon"), TEXT("room"), TEXT("door"), TEXT("torch"), TEXT("key"), TEXT("chest"), TEXT("enemy"), TEXT("floor") };
+        FString Text;
+        const int32 WordCount = Stream.RandRange(2, 12);
+        for (int32 Index = 0; Index < WordCount; Index++) {
+            Text += Index > 0 ? TEXT(" ") : TEXT("");
+            Text += Words[Stream.RandHelper(UE_ARRAY_COUNT(Words))];
+        }
+        if (Stream.FRand() < 0.2f) {
+            Text += TEXT(" \\\"caf\\u00e9\\\"");
+        }
+        return Text;
+    }
+
+    // Small localization table like LocalTestData.json: languages mapping keys to strings
+    FString MakeLocalizationDocument(FRandomStream& Stream) {
+        static const TCHAR* Languages[] = { TEXT("en"), TEXT("de"), TEXT("fr"), TEXT("uk") };
+        FString Json = TEXT("{\n");
+        for (int32 LanguageIndex = 0; LanguageIndex < UE_ARRAY_COUNT(Languages); LanguageIndex++) {
+            Json += FString::Printf(TEXT("%s  \"%s\": {\n"), LanguageIndex > 0 ? TEXT(",\n") : TEXT(""), Languages[LanguageIndex]);
+            for (int32 KeyIndex = 0; KeyIndex < 300; KeyIndex++) {
+                Json += FString::Printf(TEXT("%s    \"UI_Key_%04d\": \"%s\""), KeyIndex > 0 ? TEXT(",\n") : TEXT(""), KeyIndex, *MakeText(Stream));
+            }
+            Json += TEXT("\n  }");
+        }
+        return Json + TEXT("\n}\n");
+    }
+
+    // Medium room manifest: categories with weights and asset lists
+    FString MakeManifestDocument(FRandomStream& Stream) {
+        FString Json = TEXT("{\n  \"Version\": 3,\n  \"Rooms\": {\n");
+        for (int32 CategoryIndex = 0; CategoryIndex < 16; CategoryIndex++) {
+            Json += FString::Printf(TEXT("%s    \"Category%02d\": {\n      \"Weight\": %.3f,\n      \"Assets\": [\n"),
+                CategoryIndex > 0 ? TEXT(",\n") : TEXT(""), CategoryIndex, Stream.FRandRange(0.1f, 4.0f));
+            for (int32 AssetIndex = 0; AssetIndex < 200; AssetIndex++) {
+                Json += FString::Printf(TEXT("%s        { \"Directory\": \"/Game/Rooms/Category%02d/Asset_%03d\", \"Weight\": %.3f, \"Tags\": [\"Tag%d\", \"Tag%d\"], \"Boss\": %s }"),
+                    AssetIndex > 0 ? TEXT(",\n") : TEXT(""), CategoryIndex, AssetIndex, Stream.FRand(), Stream.RandHelper(8), Stream.RandHelper(8),
+                    Stream.FRand() < 0.05f ? TEXT("true") : TEXT("false"));
+            }
+            Json += TEXT("\n      ]\n    }");
+        }
+        return Json + TEXT("\n  }\n}\n");
+    }
+
+    // Multi megabyte array of flat records, bindable into FJsonBenchRows
+    FString MakeRowsDocument(FRandomStream& Stream, int32 RowCount) {
+        FString Json = TEXT("{\"Rows\":[\n");
+        Json.Reserve(RowCount * 100);
+        for (int32 RowIndex = 0; RowIndex < RowCount; RowIndex++) {
+            Json += FString::Printf(TEXT("%s{\"Id\":%d,\"X\":%.4f,\"Y\":%.4f,\"Z\":%.4f,\"Name\":\"Row_%d\",\"bEnabled\":%s}"),
+                RowIndex > 0 ? TEXT(",\n") : TEXT(""), RowIndex, Stream.FRandRange(-1e4f, 1e4f), Stream.FRandRange(-1e4f, 1e4f), Stream.FRandRange(-1e3f, 1e3f),
+                RowIndex, Stream.FRand() < 0.5f ? TEXT("true") : TEXT("false"));
+        }
+        return Json + TEXT("\n]}\n");
+    }
+
+    // Random documents for the equivalence fuzz. Strings mix escapes, multi byte characters and runs long enough
+    // for the vector scanners, whitespace comes in runs of every length
+    class FJsonFuzzGenerator {
+    public:
+        explicit FJsonFuzzGenerator(FRandomStream& InStream) : Stream(InStream) {}
+
+        FString MakeDocument() {
+            FString Json;
+            AppendWhitespace(Json);
+            AppendObject(Json, 0);
+            AppendWhitespace(Json);
+            return Json;
+        }
+
+    private:
+        void AppendWhitespace(FString& Json) {
+            static const TCHAR Whitespace[] = { TEXT(' '), TEXT('\n'), TEXT('\r'), TEXT('\t') };
+            const int32 Count = Stream.RandHelper(4) == 0 ? Stream.RandRange(1, 48) : Stream.RandHelper(2);
+            for (int32 Index = 0; Index < Count; Index++) {
+                Json.AppendChar(Whitespace[Stream.RandHelper(UE_ARRAY_COUNT(Whitespace))]);
+            }
+        }
+
+        void AppendString(FString& Json) {
+            static const TCHAR* Pieces[] = {
+                TEXT("a"), TEXT("Room"), TEXT(" "), TEXT("0123456789"), TEXT("\\\""), TEXT("\\\\"), TEXT("\\/"), TEXT("\\b"), TEXT("\\f"),
+                TEXT("\\n"), TEXT("\\r"), TEXT("\\t"), TEXT("\\u00e9"), TEXT("\\u20AC"), TEXT("\\ud83d\\ude00"), TEXT("\u00e9"), TEXT("\u0416"), TEXT("\u20AC")
+            };
+            const int32 Count = Stream.RandHelper(4) == 0 ? Stream.RandRange(16, 96) : Stream.RandHelper(8);
+            Json.AppendChar(TEXT('"'));
+            for (int32 Index = 0; Index < Count; Index++) {
+                Json += Pieces[Stream.RandHelper(UE_ARRAY_COUNT(Pieces))];
+            }
+            Json.AppendChar(TEXT('"'));
+        }
+
+        void AppendNumber(FString& Json) {
+            switch (Stream.RandHelper(4)) {
+            case 0: Json += FString::Printf(TEXT("%d"), Stream.RandRange(-100000, 100000)); break;
+            case 1: Json += FString::Printf(TEXT("%d.%d"), Stream.RandRange(-1000, 1000), Stream.RandHelper(100)); break;
+            case 2: Json += FString::Printf(TEXT("%de%d"), Stream.RandRange(1, 9), Stream.RandRange(-5, 5)); break;
+            default: Json += TEXT("0"); break;
+            }
+        }
+
+        void AppendValue(FString& Json, int32 Depth) {
+            const int32 Kind = Stream.RandHelper(Depth < 5 ? 8 : 6);
+            switch (Kind) {
+            case 0: case 1: AppendString(Json); break;
+            case 2: AppendNumber(Json); break;
+            case 3: Json += Stream.FRand() < 0.5f ? TEXT("true") : TEXT("false"); break;
+            case 4: Json += TEXT("null"); break;
+            case 5: AppendString(Json); break;
+            case 6: AppendObject(Json, Depth + 1); break;
+            default: AppendArray(Json, Depth + 1); break;
+            }
+        }
+
+        void AppendObject(FString& Json, int32 Depth) {
+            Json.AppendChar(TEXT('{'));
+            const int32 Count = Stream.RandHelper(6);
+            for (int32 Index = 0; Index < Count; Index++) {
+                AppendWhitespace(Json);
+                if (Index > 0) {
+                    Json.AppendChar(TEXT(','));
+                    AppendWhitespace(Json);
+                }
+
+                // Keys are kept unique, duplicates resolve the same in both parsers but would hide differences
+                FString Key;
+                AppendString(Key);
+                Key.InsertAt(Key.Len() - 1, FString::Printf(TEXT("_%d"), Index));
+                Json += Key;
+                AppendWhitespace(Json);
+                Json.AppendChar(TEXT(':'));
+                AppendWhitespace(Json);
+                AppendValue(Json, Depth);
+            }
+            AppendWhitespace(Json);
+            Json.AppendChar(TEXT('}'));
+        }
+
+        void AppendArray(FString& Json, int32 Depth) {
+            Json.AppendChar(TEXT('['));
+            const int32 Count = Stream.RandHelper(6);
+            for (int32 Index = 0; Index < Count; Index++) {
+                AppendWhitespace(Json);
+                if (Index > 0) {
+                    Json.AppendChar(TEXT(','));
+                    AppendWhitespace(Json);
+                }
+                AppendValue(Json, Depth);
+            }
+            AppendWhitespace(Json);
+            Json.AppendChar(TEXT(']'));
+        }
+
+        FRandomStream& Stream;
+    };
+
+    FString ToCondensedString(const TSharedPtr<FJsonObject>& Object) {
+        FString Result;
+        if (Object.IsValid()) {
+            FJsonSerializer::Serialize(Object.ToSharedRef(), TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Result));
+        }
+        return Result;
+    }
+
+    // Checks that the tape parser agrees with TJsonReader on valid and mutated documents, and that its vector and scalar
+    // scanners agree on everything. Returns the number of failed cases
+    int32 RunFuzz(int32 Seed, int32 Cases) {
+        IConsoleVariable* SimdScan = IConsoleManager::Get().FindConsoleVariable(TEXT("Json.SimdScan"));
+        const bool bSimdScanWas = SimdScan->GetBool();
+
+        auto ParseTape = [SimdScan](TArrayView<const uint8> Bytes, bool bSimd, FJsonTapeDocument& Document) {
+            SimdScan->Set(bSimd, ECVF_SetByCode);
+            return Document.ParseView(Bytes);
+            };
+
+        FRandomStream Stream(Seed);
+        FJsonFuzzGenerator Generator(Stream);
+        int32 Failures = 0;
+        for (int32 Case = 0; Case < Cases; Case++) {
+            const FString Json = Generator.MakeDocument();
+            FTCHARToUTF8 Utf8(*Json);
+            TArray<uint8> Bytes(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+
+            TSharedPtr<FJsonObject> Reference;
+            FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Reference);
+
+            FJsonTapeDocument Scalar;
+            FJsonTapeDocument Simd;
+            const bool bScalar = ParseTape(Bytes, false, Scalar);
+            const bool bSimd = ParseTape(Bytes, true, Simd);
+            const FString Expected = ToCondensedString(Reference);
+            if (!Reference.IsValid() or !bScalar or !bSimd
+                or ToCondensedString(Scalar.GetRoot().ToJsonObject()) != Expected or ToCondensedString(Simd.GetRoot().ToJsonObject()) != Expected) {
+                UE_LOG(LogJsonBench, Error, TEXT("Case %d: parsers disagree on a valid document (%s)\n%s"), Case, *Scalar.GetErrorMessage(), *Json);
+                Failures++;
+                continue;
+            }
+
+            // Damage a few bytes, the scanners must still reach the same verdict at the same byte
+            for (int32 Mutation = Stream.RandRange(1, 3); Mutation > 0 and Bytes.Num() > 1; Mutation--) {
+                static const uint8 Replacements[] = { '"', '\\', '{', '}', '[', ']', ',', ':', ' ', '\n', 0x01, 0x1F, 0x80, 'u', '0' };
+                const int32 At = Stream.RandHelper(Bytes.Num());
+                switch (Stream.RandHelper(3)) {
+                case 0: Bytes[At] = Replacements[Stream.RandHelper(UE_ARRAY_COUNT(Replacements))]; break;
+                case 1: Bytes.RemoveAt(At); break;
+                default: Bytes.SetNum(At); break;
+                }
+            }
+
+            const bool bMutatedScalar = ParseTape(Bytes, false, Scalar);
+            const bool bMutatedSimd = ParseTape(Bytes, true, Simd);
+            if (bMutatedScalar != bMutatedSimd or Scalar.GetErrorOffset() != Simd.GetErrorOffset() or Scalar.GetErrorMessage() != Simd.GetErrorMessage()
+                or (bMutatedScalar and ToCondensedString(Scalar.GetRoot().ToJsonObject()) != ToCondensedString(Simd.GetRoot().ToJsonObject()))) {
+                UE_LOG(LogJsonBench, Error, TEXT("Case %d: scalar and vector scans disagree on a mutated document: '%s' at %lld vs '%s' at %lld"),
+                    Case, *Scalar.GetErrorMessage(), Scalar.GetErrorOffset(), *Simd.GetErrorMessage(), Simd.GetErrorOffset());
+                Failures++;
+                continue;
+            }
+
+            // TJsonReader has to reach the same verdict, an object root the way ParseJSONString takes it, and the same DOM.
+            // The one difference allowed is a raw control character in a string, RFC 8259 forbids it and TJsonReader lets it through
+            const FUTF8ToTCHAR MutatedText(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+            TSharedPtr<FJsonObject> MutatedReference;
+            const bool bReaderAccepts = FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FString(MutatedText.Length(), MutatedText.Get())), MutatedReference)
+                and MutatedReference.IsValid();
+            const bool bTapeAccepts = bMutatedScalar and Scalar.GetRoot().IsObject();
+            const bool bStricter = bReaderAccepts and !bMutatedScalar and Scalar.GetErrorMessage() == TEXT("Control character in string");
+            if (bTapeAccepts != bReaderAccepts and !bStricter) {
+                UE_LOG(LogJsonBench, Error, TEXT("Case %d: TJsonReader %s a mutated document the tape parser %s ('%s' at %lld)"), Case,
+                    bReaderAccepts ? TEXT("accepts") : TEXT("rejects"), bTapeAccepts ? TEXT("accepts") : TEXT("rejects"), *Scalar.GetErrorMessage(), Scalar.GetErrorOffset());
+                Failures++;
+            }
+            else if (bTapeAccepts and ToCondensedString(Scalar.GetRoot().ToJsonObject()) != ToCondensedString(MutatedReference)) {
+                UE_LOG(LogJsonBench, Error, TEXT("Case %d: TJsonReader and the tape parser build different values from a mutated document"), Case);
+                Failures++;
+            }
+        }
+
+        SimdScan->Set(bSimdScanWas, ECVF_SetByCode);
+        UE_LOG(LogJsonBench, Display, TEXT("Fuzzed %d documents with seed %d, %d failures"), Cases, Seed, Failures);
+        return Failures;
+    }
+
+    bool AddDocument(TArray<FBenchDocument>& Documents, const TCHAR* Name, const FString& Json, const TCHAR* AccessPath, bool bBindRows) {
+        FBenchDocument& Document = Documents.AddDefaulted_GetRef();
+        Document.Name = Name;
+        Document.AccessPath = AccessPath;
+        Document.bBindRows = bBindRows;
+
+        FTCHARToUTF8 Utf8(*Json);
+        Document.Text.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+
+        FJsonTapeDocument Tape;
+        if (!Tape.ParseView(Document.Text) or !Tape.WriteCooked(Document.Cooked)) {
+            UE_LOG(LogJsonBench, Error, TEXT("%s: generated document does not parse, %s at byte %lld"), Name, *Tape.GetErrorMessage(), Tape.GetErrorOffset());
+            return false;
+        }
+        return true;
+    }
+}
+
+UJsonBenchCommandlet::UJsonBenchCommandlet() {
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UJsonBenchCommandlet::Main(const FString& Params) {
+    int32 Iterations = 20;
+    int32 Seed = 1;
+    FString OutputFile = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("JsonBench"), FString::Printf(TEXT("JsonBench-%s.json"), *FDateTime::UtcNow().ToString()));
+    FParse::Value(*Params, TEXT("Iterations="), Iterations);
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    FParse::Value(*Params, TEXT("Output="), OutputFile);
+    Iterations = FMath::Max(Iterations, 1);
+
+    int32 FuzzCases = 0;
+    if (FParse::Value(*Params, TEXT("Fuzz="), FuzzCases)) {
+        return RunFuzz(Seed, FuzzCases) > 0 ? 1 : 0;
+    }
+
+    FRandomStream Stream(Seed);
+    TArray<FBenchDocument> Documents;
+    if (!AddDocument(Documents, TEXT("Localization"), MakeLocalizationDocument(Stream), TEXT("*.*"), false)
+        or !AddDocument(Documents, TEXT("Manifest"), MakeManifestDocument(Stream), TEXT("Rooms.*.Assets[*].Directory"), false)
+        or !AddDocument(Documents, TEXT("Rows"), MakeRowsDocument(Stream, 48000), TEXT("Rows[*].Name"), true)) {
+        return 1;
+    }
+
+    FJsonBench Bench(Iterations);
+    for (const FBenchDocument& Document : Documents) {
+        UE_LOG(LogJsonBench, Display, TEXT("%s: %d text bytes, %d cooked bytes"), *Document.Name, Document.Text.Num(), Document.Cooked.Num());
+        Bench.Run(Document);
+    }
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+    Report->SetStringField(TEXT("Platform"), FPlatformMisc::GetUBTPlatform());
+    Report->SetStringField(TEXT("Configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Report->SetNumberField(TEXT("Seed"), Seed);
+    Report->SetNumberField(TEXT("Iterations"), Iterations);
+
+    TArray<TSharedPtr<FJsonValue>> DocumentValues;
+    for (const FBenchDocument& Document : Documents) {
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("Name"), Document.Name);
+        Entry->SetNumberField(TEXT("TextBytes"), Document.Text.Num());
+        Entry->SetNumberField(TEXT("CookedBytes"), Document.Cooked.Num());
+        Entry->SetStringField(TEXT("AccessPath"), Document.AccessPath);
+        DocumentValues.Add(MakeShared<FJsonValueObject>(Entry));
+    }
+    Report->SetArrayField(TEXT("Documents"), DocumentValues);
+
+    TArray<TSharedPtr<FJsonValue>> ResultValues;
+    for (const FBenchResult& Result : Bench.Results) {
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("Document"), Result.Document);
+        Entry->SetStringField(TEXT("Method"), Result.Method);
+        Entry->SetStringField(TEXT("Phase"), Result.Phase);
+        Entry->SetNumberField(TEXT("Iterations"), Result.Iterations);
+        Entry->SetNumberField(TEXT("MilliSeconds"), Result.Seconds * 1e3);
+        Entry->SetNumberField(TEXT("MBPerSecond"), Result.MBPerSecond);
+        Entry->SetNumberField(TEXT("Allocations"), static_cast<double>(Result.Allocations));
+        Entry->SetNumberField(TEXT("PeakBytes"), static_cast<double>(Result.PeakBytes));
+        Entry->SetNumberField(TEXT("Checksum"), static_cast<double>(Result.Checksum));
+        ResultValues.Add(MakeShared<FJsonValueObject>(Entry));
+    }
+    Report->SetArrayField(TEXT("Results"), ResultValues);
+
+    FString ReportString;
+    FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&ReportString));
+    if (!FFileHelper::SaveStringToFile(ReportString, *OutputFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)) {
+        UE_LOG(LogJsonBench, Error, TEXT("Could not write %s"), *OutputFile);
+        return 1;
+    }
+
+    UE_LOG(LogJsonBench, Display, TEXT("Wrote %d results to %s"), Bench.Results.Num(), *OutputFile);
+    return 0;
+}
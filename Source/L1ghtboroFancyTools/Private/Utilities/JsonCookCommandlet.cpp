@@ -0,0 +1,60 @@
+#include "Utilities/JsonCookCommandlet.h"
+#include "Utilities/JsonLibrary.h"
+#include "Utilities/JsonTapeDocument.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogJsonCook, Log, All);
+
+UJsonCookCommandlet::UJsonCookCommandlet() {
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UJsonCookCommandlet::Main(const FString& Params) {
+    FString Directory;
+    FParse::Value(*Params, TEXT("Dir="), Directory);
+    const FString RootDirectory = FPaths::Combine(FPaths::ProjectContentDir(), Directory);
+    const bool bClean = FParse::Param(*Params, TEXT("Clean"));
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFilesRecursive(Files, *RootDirectory, TEXT("*.json"), true, false);
+
+    int32 Failures = 0;
+    int64 TextBytes = 0;
+    int64 CookedBytes = 0;
+    for (const FString& File : Files) {
+        const FString CookedFile = UJsonLibrary::GetCookedJSONPath(File);
+        if (bClean) {
+            IFileManager::Get().Delete(*CookedFile, false, false, true);
+            continue;
+        }
+
+        // The stamp lets loaders tell when the text was edited after this cook
+        const FFileStatData SourceStat = IFileManager::Get().GetStatData(*File);
+
+        FJsonTapeDocument Document;
+        TArray<uint8> Cooked;
+        if (!Document.LoadFile(File) or !Document.WriteCooked(Cooked, SourceStat.FileSize, SourceStat.ModificationTime)) {
+            UE_LOG(LogJsonCook, Error, TEXT("%s: %s at byte %lld"), *File, *Document.GetErrorMessage(), Document.GetErrorOffset());
+            Failures++;
+            continue;
+        }
+        if (!FFileHelper::SaveArrayToFile(Cooked, *CookedFile)) {
+            UE_LOG(LogJsonCook, Error, TEXT("Could not write %s"), *CookedFile);
+            Failures++;
+            continue;
+        }
+
+        const int64 FileSize = SourceStat.FileSize;
+        TextBytes += FileSize;
+        CookedBytes += Cooked.Num();
+        UE_LOG(LogJsonCook, Display, TEXT("%s: %lld -> %d bytes"), *CookedFile, FileSize, Cooked.Num());
+    }
+
+    UE_LOG(LogJsonCook, Display, TEXT("%s %d JSON files under %s, %lld text bytes, %lld cooked bytes, %d failures"), bClean ? TEXT("Cleaned") : TEXT("Cooked"), Files.Num(), *RootDirectory, TextBytes, CookedBytes, Failures);
+    return Failures > 0 ? 1 : 0;
+}
@@ -3,12 +3,303 @@
 #include "Misc/Paths.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/MemoryWriter.h"
+#include "Utilities/JsonStreamReader.h"
+#include "Utilities/JsonTapeDocument.h"
+#include "Utilities/JsonStructBinding.h"
+#include "Utilities/JsonPathQuery.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/ScopeLock.h"
+#include "Async/Async.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "Windows/WindowsHWrapper.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC || PLATFORM_ANDROID || PLATFORM_IOS
+#include <stdio.h>
+#define JSON_REPLACE_WITH_RENAME 1
+#endif
+
+#ifndef JSON_REPLACE_WITH_RENAME
+#define JSON_REPLACE_WITH_RENAME 0
+#endif
+
+static TAutoConsoleVariable<bool> CVarJsonUtf8Load(
+    TEXT("Json.Utf8Load"),
+    true,
+    TEXT("Load JSON files by parsing their mapped UTF-8 bytes instead of widening them to an FString first.\n")
+    TEXT("ParseJSONString converts to UTF-8 and takes the same parser, falling back to TJsonReader for input it rejects."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarJsonUseCooked(
+    TEXT("Json.UseCooked"),
+    1,
+    TEXT("When to load the cooked .jsonbin written by the JsonCook commandlet instead of the text file.\n")
+    TEXT("0: never, 1: in cooked builds, 2: whenever one exists"),
+    ECVF_Default);
+
+namespace {
+    // Builds DOM values for the events of one root field and skips the rest of the document
+    class FJsonFieldVisitor final : public IJsonVisitor {
+    public:
+        explicit FJsonFieldVisitor(const FString& InFieldName) : FieldName(InFieldName) {}
+
+        TSharedPtr<FJsonValue> Result;
+
+        virtual EJsonVisit OnObjectStart() override {
+            if (!bInRoot) {
+                bInRoot = true;
+                return EJsonVisit::Continue;
+            }
+            Frames.AddDefaulted_GetRef().Object = MakeShared<FJsonObject>();
+            return EJsonVisit::Continue;
+        }
+
+        virtual EJsonVisit OnArrayStart() override {
+            // A root array has no fields
+            if (!bInRoot) {
+                return EJsonVisit::Stop;
+            }
+            Frames.AddDefaulted();
+            return EJsonVisit::Continue;
+        }
+
+        virtual EJsonVisit OnObjectEnd() override {
+            if (Frames.Num() == 0) {
+                return EJsonVisit::Stop;
+            }
+            FFrame Frame = Frames.Pop(false);
+            return AddValue(MakeShared<FJsonValueObject>(Frame.Object));
+        }
+
+        virtual EJsonVisit OnArrayEnd() override {
+            FFrame Frame = Frames.Pop(false);
+            return AddValue(MakeShared<FJsonValueArray>(MoveTemp(Frame.Array)));
+        }
+
+        virtual EJsonVisit OnKey(FStringView Key) override {
+            if (Frames.Num() > 0) {
+                Frames.Last().Key = FString(Key);
+                return EJsonVisit::Continue;
+            }
+            return Key == FieldName ? EJsonVisit::Continue : EJsonVisit::SkipValue;
+        }
+
+        virtual EJsonVisit OnString(FStringView Value) override { return AddValue(MakeShared<FJsonValueString>(FString(Value))); }
+        virtual EJsonVisit OnNumber(double Value) override { return AddValue(MakeShared<FJsonValueNumber>(Value)); }
+        virtual EJsonVisit OnBool(bool bValue) override { return AddValue(MakeShared<FJsonValueBoolean>(bValue)); }
+        virtual EJsonVisit OnNull() override { return AddValue(MakeShared<FJsonValueNull>()); }
+
+    private:
+        struct FFrame {
+            // Set for objects, arrays collect into Array
+            TSharedPtr<FJsonObject> Object;
+            TArray<TSharedPtr<FJsonValue>> Array;
+            FString Key;
+        };
+
+        // The field is complete once a value lands outside of every open frame
+        EJsonVisit AddValue(const TSharedRef<FJsonValue>& Value) {
+            if (Frames.Num() == 0) {
+                Result = Value;
+                return EJsonVisit::Stop;
+            }
+
+            FFrame& Top = Frames.Last();
+            if (Top.Object.IsValid()) {
+                Top.Object->SetField(Top.Key, Value);
+            }
+            else {
+                Top.Array.Add(Value);
+            }
+            return EJsonVisit::Continue;
+        }
+
+        const FString& FieldName;
+        TArray<FFrame> Frames;
+        bool bInRoot = false;
+    };
+
+    // Put From in place of To in one step, readers see the old file or the new one and never neither.
+    // Platforms without such a call keep the old file as a .bak until the new one is in place, and restore it on failure
+    bool ReplaceFile(const FString& From, const FString& To) {
+        IFileManager& FileManager = IFileManager::Get();
+#if PLATFORM_WINDOWS
+        const FString PlatformFrom = FileManager.ConvertToAbsolutePathForExternalAppForWrite(*From);
+        const FString PlatformTo = FileManager.ConvertToAbsolutePathForExternalAppForWrite(*To);
+        return MoveFileExW(*PlatformFrom, *PlatformTo, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#elif JSON_REPLACE_WITH_RENAME
+        const FString PlatformFrom = FileManager.ConvertToAbsolutePathForExternalAppForWrite(*From);
+        const FString PlatformTo = FileManager.ConvertToAbsolutePathForExternalAppForWrite(*To);
+        return rename(TCHAR_TO_UTF8(*PlatformFrom), TCHAR_TO_UTF8(*PlatformTo)) == 0;
+#else
+        const FString BackupFilePath = To + TEXT(".bak");
+        const bool bHadTarget = FileManager.FileExists(*To);
+        if (bHadTarget and !FileManager.Move(*BackupFilePath, *To, true, true)) {
+            return false;
+        }
+        if (!FileManager.Move(*To, *From, true, true)) {
+            if (bHadTarget) {
+                FileManager.Move(*To, *BackupFilePath, true, true);
+            }
+            return false;
+        }
+        if (bHadTarget) {
+            FileManager.Delete(*BackupFilePath, false, true, true);
+        }
+        return true;
+#endif
+    }
+
+    // Serialize into a temp file beside the target and replace the target with it once it is complete
+    bool WriteJSONFileAtomic(const FString& AbsoluteFilePath, const TSharedRef<FJsonObject>& JsonObject, bool bCompress) {
+        IFileManager& FileManager = IFileManager::Get();
+        const FString TempFilePath = FPaths::CreateTempFilename(*FPaths::GetPath(AbsoluteFilePath), *FPaths::GetBaseFilename(AbsoluteFilePath), TEXT(".tmp"));
+
+        bool bWritten = false;
+        {
+            TUniquePtr<FArchive> File(FileManager.CreateFileWriter(*TempFilePath));
+            if (!File) {
+                UE_LOG(LogTemp, Error, TEXT("Failed to create file: %s"), *TempFilePath);
+                return false;
+            }
+
+            if (bCompress) {
+                TArray<uint8> Text;
+                FMemoryWriter TextWriter(Text);
+                TArray<uint8> Compressed;
+                bWritten = FJsonSerializer::Serialize(JsonObject, TJsonWriterFactory<UTF8CHAR>::Create(&TextWriter))
+                    and FJsonTapeDocument::WriteCompressed(Text, Compressed);
+                if (bWritten) {
+                    File->Serialize(Compressed.GetData(), Compressed.Num());
+                }
+            }
+            else {
+                bWritten = FJsonSerializer::Serialize(JsonObject, TJsonWriterFactory<UTF8CHAR>::Create(File.Get()));
+            }
+
+            // Close flushes the buffered tail, write errors show up there
+            bWritten = File->Close() and bWritten;
+        }
+
+        // Close leaves the bytes in the OS cache. Sync them to disk before the rename, or a crash can leave the
+        // renamed file empty. The sync covers the file, so a second handle is enough
+        if (bWritten) {
+            TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*TempFilePath, true));
+            bWritten = Handle and Handle->Flush(true);
+        }
+
+        if (!bWritten or !ReplaceFile(TempFilePath, AbsoluteFilePath)) {
+            FileManager.Delete(*TempFilePath, false, true, true);
+            UE_LOG(LogTemp, Error, TEXT("Failed to save file: %s"), *AbsoluteFilePath);
+            return false;
+        }
+        return true;
+    }
+
+    struct FQueuedSave {
+        TSharedPtr<FJsonObject> JsonObject;
+        bool bCompress = false;
+        TArray<TSharedRef<TPromise<bool>>> Promises;
+    };
+
+    // Latest save waiting for each path, a path stays in RunningSaves while a worker owns it
+    FCriticalSection SaveQueueLock;
+    TMap<FString, FQueuedSave> QueuedSaves;
+    TSet<FString> RunningSaves;
+
+    void RunQueuedSaves(const FString& AbsoluteFilePath) {
+        for (;;) {
+            FQueuedSave Save;
+            {
+                FScopeLock Lock(&SaveQueueLock);
+                if (!QueuedSaves.RemoveAndCopyValue(AbsoluteFilePath, Save)) {
+                    RunningSaves.Remove(AbsoluteFilePath);
+                    return;
+                }
+            }
+
+            const bool bSaved = WriteJSONFileAtomic(AbsoluteFilePath, Save.JsonObject.ToSharedRef(), Save.bCompress);
+            for (const TSharedRef<TPromise<bool>>& Promise : Save.Promises) {
+                Promise->SetValue(bSaved);
+            }
+        }
+    }
+
+    // Load the cooked file where Json.UseCooked allows it, the text file otherwise. Leaves reporting to the caller
+    bool LoadTapeDocument(FJsonTapeDocument& Document, const FString& FilePath) {
+        const FString AbsoluteFilePath = FPaths::ProjectContentDir() + FilePath;
+
+        // Development builds read the text so edits show up right away, a stale cooked file is never picked there by default
+        const int32 UseCooked = CVarJsonUseCooked.GetValueOnAnyThread();
+        if (UseCooked == 2 or (UseCooked == 1 and FPlatformProperties::RequiresCookedData())) {
+            const FString CookedFilePath = UJsonLibrary::GetCookedJSONPath(AbsoluteFilePath);
+            if (IFileManager::Get().FileExists(*CookedFilePath) and Document.LoadFile(CookedFilePath)) {
+                // A cooked file only counts while its header still names the text beside it. Staging keeps the size
+                // of the text but not its modification time, so cooked builds compare the size alone
+                const FFileStatData SourceStat = IFileManager::Get().GetStatData(*AbsoluteFilePath);
+                if (!SourceStat.bIsValid) {
+                    return true;
+                }
+                if (FPlatformProperties::RequiresCookedData()) {
+                    if (Document.GetCookedSourceSize() == SourceStat.FileSize) {
+                        return true;
+                    }
+                }
+                else if (Document.IsCookedFrom(SourceStat.FileSize, SourceStat.ModificationTime)) {
+                    return true;
+                }
+                UE_LOG(LogTemp, Warning, TEXT("%s was cooked from another version of %s, loading the text instead"), *CookedFilePath, *FilePath);
+            }
+        }
+        return Document.LoadFile(AbsoluteFilePath);
+    }
+
+    // Text of a file for TJsonReader, unpacked first when it was saved compressed. Decodes the encoding like LoadFileToString
+    bool LoadJSONText(const FString& AbsoluteFilePath, FString& OutText) {
+        TArray<uint8> Bytes;
+        if (!FFileHelper::LoadFileToArray(Bytes, *AbsoluteFilePath, FILEREAD_Silent)) {
+            return false;
+        }
+        if (FJsonTapeDocument::IsCompressed(Bytes)) {
+            TArray<uint8> Text;
+            if (!FJsonTapeDocument::Uncompress(Bytes, Text)) {
+                return false;
+            }
+            Bytes = MoveTemp(Text);
+        }
+        FFileHelper::BufferToString(OutText, Bytes.GetData(), Bytes.Num());
+        return true;
+    }
+
+    bool StreamJSON(FJsonStreamReader& Reader, const FString& FilePath, IJsonVisitor& Visitor) {
+        if (!Reader.Read(Visitor)) {
+            UE_LOG(LogTemp, Error, TEXT("Failed to parse %s at byte %lld: %s"), *FilePath, Reader.GetErrorOffset(), *Reader.GetErrorMessage());
+            return false;
+        }
+        return true;
+    }
+}
 
 TSharedPtr<FJsonObject> UJsonLibrary::LoadJSONFromFile(const FString& FilePath) {
+    if (CVarJsonUtf8Load.GetValueOnAnyThread()) {
+        FJsonTapeDocument Document;
+        if (LoadTapeDocument(Document, FilePath) and Document.GetRoot().IsObject()) {
+            return Document.GetRoot().ToJsonObject();
+        }
+        // UTF-16 files (the tape parser stops at their byte order mark) and anything else it rejects are read
+        // below, LoadJSONText decodes the encoding and ParseJSONString falls back to TJsonReader
+    }
+
     FString JsonString;
     FString AbsoluteFilePath = FPaths::ProjectContentDir() + FilePath;
 
-    if (!FFileHelper::LoadFileToString(JsonString, *AbsoluteFilePath)) {
+    if (!LoadJSONText(AbsoluteFilePath, JsonString)) {
         UE_LOG(LogTemp, Error, TEXT("Failed to load file: %s"), *FilePath);
         return nullptr;
     }
@@ -16,17 +307,105 @@ TSharedPtr<FJsonObject> UJsonLibrary::LoadJSONFromFile(const FString& FilePath)
     return ParseJSONString(JsonString);
 }
 
+TFuture<TSharedPtr<FJsonObject>> UJsonLibrary::LoadJSONFromFileAsync(const FString& FilePath) {
+    return Async(EAsyncExecution::ThreadPool, [FilePath]() {
+        return LoadJSONFromFile(FilePath);
+        });
+}
+
+void UJsonLibrary::LoadJSONFilesAsync(const TArray<FString>& FilePaths, FOnJSONFilesLoaded OnLoaded) {
+    struct FBatch {
+        TArray<TSharedPtr<FJsonObject>> Objects;
+        FThreadSafeCounter Remaining;
+        FOnJSONFilesLoaded OnLoaded;
+    };
+
+    TSharedRef<FBatch> Batch = MakeShared<FBatch>();
+    Batch->Objects.SetNum(FilePaths.Num());
+    Batch->Remaining.Set(FilePaths.Num());
+    Batch->OnLoaded = MoveTemp(OnLoaded);
+
+    auto Complete = [Batch]() {
+        AsyncTask(ENamedThreads::GameThread, [Batch]() {
+            if (Batch->OnLoaded) {
+                Batch->OnLoaded(MoveTemp(Batch->Objects));
+            }
+            });
+        };
+
+    if (FilePaths.Num() == 0) {
+        Complete();
+        return;
+    }
+
+    // Every worker writes its own slot, the last one to finish hands the batch to the game thread
+    for (int32 Index = 0; Index < FilePaths.Num(); Index++) {
+        Async(EAsyncExecution::ThreadPool, [Batch, Complete, FilePath = FilePaths[Index], Index]() {
+            Batch->Objects[Index] = LoadJSONFromFile(FilePath);
+            if (Batch->Remaining.Decrement() == 0) {
+                Complete();
+            }
+            });
+    }
+}
+
+TSharedPtr<FJsonTapeDocument> UJsonLibrary::LoadJSONDocument(const FString& FilePath) {
+    TSharedPtr<FJsonTapeDocument> Document = MakeShared<FJsonTapeDocument>();
+    if (!LoadTapeDocument(*Document, FilePath)) {
+        UE_LOG(LogTemp, Error, TEXT("Failed to load %s at byte %lld: %s"), *FilePath, Document->GetErrorOffset(), *Document->GetErrorMessage());
+        return nullptr;
+    }
+    return Document;
+}
+
+FString UJsonLibrary::GetCookedJSONPath(const FString& AbsoluteFilePath) {
+    return FPaths::ChangeExtension(AbsoluteFilePath, TEXT("jsonbin"));
+}
+
 bool UJsonLibrary::SaveJSONToFile(const FString& FilePath, const TSharedPtr<FJsonObject>& JsonObject) {
-    FString OutputString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-    if (FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer)) {
-        FString AbsoluteFilePath = FPaths::ProjectContentDir() + FilePath;
-        return FFileHelper::SaveStringToFile(OutputString, *AbsoluteFilePath);
+    if (!JsonObject.IsValid()) {
+        return false;
     }
-    return false;
+    return WriteJSONFileAtomic(FPaths::ProjectContentDir() + FilePath, JsonObject.ToSharedRef(), false);
+}
+
+TFuture<bool> UJsonLibrary::SaveJSONToFileAsync(const FString& FilePath, const TSharedPtr<FJsonObject>& JsonObject, bool bCompress) {
+    if (!JsonObject.IsValid()) {
+        return MakeFulfilledPromise<bool>(false).GetFuture();
+    }
+
+    const FString AbsoluteFilePath = FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir() + FilePath);
+    TSharedRef<TPromise<bool>> Promise = MakeShared<TPromise<bool>>();
+    TFuture<bool> Future = Promise->GetFuture();
+
+    FScopeLock Lock(&SaveQueueLock);
+
+    // A save still waiting for this path is replaced, its callers get the result of this one
+    FQueuedSave& Save = QueuedSaves.FindOrAdd(AbsoluteFilePath);
+    Save.JsonObject = JsonObject;
+    Save.bCompress = bCompress;
+    Save.Promises.Add(Promise);
+
+    bool bAlreadyRunning = false;
+    RunningSaves.Add(AbsoluteFilePath, &bAlreadyRunning);
+    if (!bAlreadyRunning) {
+        Async(EAsyncExecution::ThreadPool, [AbsoluteFilePath]() {
+            RunQueuedSaves(AbsoluteFilePath);
+            });
+    }
+    return Future;
 }
 
 TSharedPtr<FJsonObject> UJsonLibrary::ParseJSONString(const FString& JsonString) {
+    if (CVarJsonUtf8Load.GetValueOnAnyThread()) {
+        FTCHARToUTF8 Utf8(*JsonString);
+        FJsonTapeDocument Document;
+        if (Document.ParseView(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length())) and Document.GetRoot().IsObject()) {
+            return Document.GetRoot().ToJsonObject();
+        }
+        // Input the tape parser turns down goes through TJsonReader, so callers keep its results and its errors
+    }
+
     TSharedPtr<FJsonObject> JsonObject;
     TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
     if (FJsonSerializer::Deserialize(Reader, JsonObject)) {
@@ -36,6 +415,59 @@ TSharedPtr<FJsonObject> UJsonLibrary::ParseJSONString(const FString& JsonString)
     return nullptr;
 }
 
+bool UJsonLibrary::StreamJSONFromFile(const FString& FilePath, IJsonVisitor& Visitor) {
+    FString AbsoluteFilePath = FPaths::ProjectContentDir() + FilePath;
+
+    TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*AbsoluteFilePath));
+    if (!File) {
+        UE_LOG(LogTemp, Error, TEXT("Failed to open file: %s"), *FilePath);
+        return false;
+    }
+
+    // Compressed saves are unpacked into memory and streamed from there, anything else straight from the file
+    const int64 FileSize = File->Size();
+    uint8 Prefix[FJsonTapeDocument::CompressedHeaderSize];
+    const int32 PrefixSize = static_cast<int32>(FMath::Clamp<int64>(FileSize, 0, sizeof(Prefix)));
+    if (File->Read(Prefix, PrefixSize) and FJsonTapeDocument::IsCompressed(TArrayView<const uint8>(Prefix, PrefixSize))) {
+        TArray<uint8> Packed;
+        TArray<uint8> Text;
+        if (FileSize > MAX_int32) {
+            UE_LOG(LogTemp, Error, TEXT("Compressed file is too large: %s"), *FilePath);
+            return false;
+        }
+        Packed.SetNumUninitialized(static_cast<int32>(FileSize));
+        if (!File->Seek(0) or !File->Read(Packed.GetData(), Packed.Num()) or !FJsonTapeDocument::Uncompress(Packed, Text)) {
+            UE_LOG(LogTemp, Error, TEXT("Failed to unpack compressed file: %s"), *FilePath);
+            return false;
+        }
+        FJsonStreamReader Reader(Text);
+        return StreamJSON(Reader, FilePath, Visitor);
+    }
+
+    if (!File->Seek(0)) {
+        UE_LOG(LogTemp, Error, TEXT("Failed to open file: %s"), *FilePath);
+        return false;
+    }
+    FJsonStreamReader Reader(*File);
+    return StreamJSON(Reader, FilePath, Visitor);
+}
+
+TSharedPtr<FJsonValue> UJsonLibrary::LoadJSONFieldFromFile(const FString& FilePath, const FString& FieldName) {
+    FJsonFieldVisitor Visitor(FieldName);
+    if (!StreamJSONFromFile(FilePath, Visitor)) {
+        return nullptr;
+    }
+    return Visitor.Result;
+}
+
+bool UJsonLibrary::LoadJSONStructFromFile(const FString& FilePath, const UScriptStruct* Struct, void* OutStructData) {
+    TSharedPtr<FJsonTapeDocument> Document = LoadJSONDocument(FilePath);
+    if (!Document.IsValid()) {
+        return false;
+    }
+    return FJsonStructBinding::BindStruct(Document->GetRoot(), Struct, OutStructData);
+}
+
 bool UJsonLibrary::GetStringField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName, FString& OutString) {
     if (JsonObject->HasField(FieldName)) {
         OutString = JsonObject->GetStringField(FieldName);
@@ -74,4 +506,12 @@ bool UJsonLibrary::GetArrayField(const TSharedPtr<FJsonObject>& JsonObject, cons
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+bool UJsonLibrary::GetStringAtPath(const TSharedPtr<FJsonObject>& JsonObject, const FJsonPathQuery& Query, FString& OutString) {
+    return JsonObject.IsValid() and Query.FindString(*JsonObject, OutString);
+}
+
+bool UJsonLibrary::GetValuesAtPath(const TSharedPtr<FJsonObject>& JsonObject, const FJsonPathQuery& Query, TArray<const FJsonValue*>& OutValues) {
+    return JsonObject.IsValid() and Query.FindAll(*JsonObject, OutValues) > 0;
+}
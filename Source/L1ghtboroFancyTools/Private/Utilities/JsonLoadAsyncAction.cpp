@@ -0,0 +1,35 @@
+#include "Utilities/JsonLoadAsyncAction.h"
+#include "Utilities/JsonLibrary.h"
+
+UJsonLoadAsyncAction* UJsonLoadAsyncAction::LoadJSONFilesAsync(UObject* WorldContextObject, const TArray<FString>& FilePaths) {
+    UJsonLoadAsyncAction* Action = NewObject<UJsonLoadAsyncAction>();
+    Action->FilePaths = FilePaths;
+    Action->RegisterWithGameInstance(WorldContextObject);
+    return Action;
+}
+
+void UJsonLoadAsyncAction::Activate() {
+    TWeakObjectPtr<UJsonLoadAsyncAction> WeakThis(this);
+    UJsonLibrary::LoadJSONFilesAsync(FilePaths, [WeakThis](TArray<TSharedPtr<FJsonObject>>&& Objects) {
+        UJsonLoadAsyncAction* Action = WeakThis.Get();
+        if (!Action) {
+            return;
+        }
+
+        TArray<FJsonObjectWrapper> Wrappers;
+        Wrappers.Reserve(Objects.Num());
+        bool bAllLoaded = true;
+        for (TSharedPtr<FJsonObject>& Object : Objects) {
+            bAllLoaded = bAllLoaded and Object.IsValid();
+            Wrappers.AddDefaulted_GetRef().JsonObject = MoveTemp(Object);
+        }
+
+        if (bAllLoaded) {
+            Action->Loaded.Broadcast(Wrappers);
+        }
+        else {
+            Action->Failed.Broadcast(Wrappers);
+        }
+        Action->SetReadyToDestroy();
+        });
+}
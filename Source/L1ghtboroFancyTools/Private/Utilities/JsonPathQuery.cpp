@@ -0,0 +1,239 @@
+#include "Utilities/JsonPathQuery.h"
+#include "Algo/AllOf.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+namespace {
+    using FDomVisitor = TFunctionRef<bool(const FJsonValue& Value)>;
+    using FTapeVisitor = TFunctionRef<bool(FJsonTapeValue Value)>;
+
+    bool WalkDom(const TArray<FJsonPathSegment>& Segments, int32 SegmentIndex, const FJsonValue& Value, FDomVisitor Visitor);
+
+    // Step from an object, shared by the root and every nested object. Returns false once the visitor asked to stop
+    bool WalkDomObject(const TArray<FJsonPathSegment>& Segments, int32 SegmentIndex, const FJsonObject& Object, FDomVisitor Visitor) {
+        const FJsonPathSegment& Segment = Segments[SegmentIndex];
+        if (Segment.Kind == FJsonPathSegment::EKind::Field) {
+            const TSharedPtr<FJsonValue>* Found = Object.Values.FindByHash(Segment.NameHash, Segment.Name);
+            return !Found or !Found->IsValid() or WalkDom(Segments, SegmentIndex + 1, **Found, Visitor);
+        }
+        if (Segment.Kind == FJsonPathSegment::EKind::Children) {
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values) {
+                if (Field.Value.IsValid() and !WalkDom(Segments, SegmentIndex + 1, *Field.Value, Visitor)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool WalkDom(const TArray<FJsonPathSegment>& Segments, int32 SegmentIndex, const FJsonValue& Value, FDomVisitor Visitor) {
+        if (SegmentIndex == Segments.Num()) {
+            return Visitor(Value);
+        }
+
+        const TSharedPtr<FJsonObject>* Object = nullptr;
+        if (Value.Type == EJson::Object and Value.TryGetObject(Object) and Object->IsValid()) {
+            return WalkDomObject(Segments, SegmentIndex, **Object, Visitor);
+        }
+
+        const TArray<TSharedPtr<FJsonValue>>* Elements = nullptr;
+        if (Value.Type != EJson::Array or !Value.TryGetArray(Elements)) {
+            return true;
+        }
+
+        const FJsonPathSegment& Segment = Segments[SegmentIndex];
+        if (Segment.Kind == FJsonPathSegment::EKind::Index) {
+            return !Elements->IsValidIndex(Segment.Index) or !(*Elements)[Segment.Index].IsValid() or WalkDom(Segments, SegmentIndex + 1, *(*Elements)[Segment.Index], Visitor);
+        }
+        if (Segment.Kind == FJsonPathSegment::EKind::Children) {
+            for (const TSharedPtr<FJsonValue>& Element : *Elements) {
+                if (Element.IsValid() and !WalkDom(Segments, SegmentIndex + 1, *Element, Visitor)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool WalkTape(const TArray<FJsonPathSegment>& Segments, int32 SegmentIndex, FJsonTapeValue Value, FTapeVisitor Visitor) {
+        if (SegmentIndex == Segments.Num()) {
+            return Visitor(Value);
+        }
+
+        const FJsonPathSegment& Segment = Segments[SegmentIndex];
+        switch (Segment.Kind) {
+        case FJsonPathSegment::EKind::Field: {
+            const FJsonTapeValue Found = Value.FindField(FUtf8StringView(Segment.Utf8Name.GetData(), Segment.Utf8Name.Num()));
+            return !Found.IsValid() or WalkTape(Segments, SegmentIndex + 1, Found, Visitor);
+        }
+        case FJsonPathSegment::EKind::Index: {
+            const FJsonTapeValue Found = Value.GetElement(Segment.Index);
+            return !Found.IsValid() or WalkTape(Segments, SegmentIndex + 1, Found, Visitor);
+        }
+        case FJsonPathSegment::EKind::Children: {
+            bool bContinue = true;
+            auto Descend = [&Segments, SegmentIndex, &Visitor, &bContinue](FJsonTapeValue Child) {
+                bContinue = WalkTape(Segments, SegmentIndex + 1, Child, Visitor);
+                return bContinue;
+                };
+            if (Value.IsObject()) {
+                Value.ForEachField([&Descend](FJsonTapeValue, FJsonTapeValue Child) { return Descend(Child); });
+            }
+            else {
+                Value.ForEachElement(Descend);
+            }
+            return bContinue;
+        }
+        }
+        return true;
+    }
+}
+
+FJsonPathQuery::FJsonPathQuery(FStringView Path) {
+    int32 At = 0;
+    while (bValid and At < Path.Len()) {
+        if (Path[At] == TEXT('[')) {
+            int32 Close = INDEX_NONE;
+            if (!Path.RightChop(At).FindChar(TEXT(']'), Close)) {
+                Fail(TEXT("Missing ']'"));
+                break;
+            }
+
+            const FStringView Inside = Path.Mid(At + 1, Close - 1);
+            if (Inside == TEXTVIEW("*")) {
+                AddChildren();
+            }
+            else if (Inside.Len() > 0 and Algo::AllOf(Inside, [](TCHAR Char) { return FChar::IsDigit(Char); })) {
+                AddIndex(FCString::Atoi(*FString(Inside)));
+            }
+            else {
+                Fail(FString::Printf(TEXT("Invalid index '%.*s'"), Inside.Len(), Inside.GetData()));
+                break;
+            }
+            At += Close + 1;
+
+            // A bracket is followed by another bracket, a '.' or the end
+            if (At < Path.Len() and Path[At] != TEXT('[') and Path[At] != TEXT('.')) {
+                Fail(TEXT("Expected '.' or '[' after ']'"));
+                break;
+            }
+        }
+        else {
+            int32 End = At;
+            while (End < Path.Len() and Path[End] != TEXT('.') and Path[End] != TEXT('[')) {
+                End++;
+            }
+            if (End == At) {
+                Fail(TEXT("Empty field name"));
+                break;
+            }
+
+            const FStringView Name = Path.Mid(At, End - At);
+            if (Name == TEXTVIEW("*")) {
+                AddChildren();
+            }
+            else {
+                AddField(FString(Name));
+            }
+            At = End;
+        }
+
+        if (At < Path.Len() and Path[At] == TEXT('.')) {
+            if (++At == Path.Len()) {
+                Fail(TEXT("Path ends with '.'"));
+            }
+        }
+    }
+}
+
+bool FJsonPathQuery::Fail(const FString& Message) {
+    bValid = false;
+    Error = Message;
+    Segments.Reset();
+    return false;
+}
+
+FJsonPathQuery& FJsonPathQuery::AddField(const FString& Name) {
+    FJsonPathSegment& Segment = Segments.AddDefaulted_GetRef();
+    Segment.Kind = FJsonPathSegment::EKind::Field;
+    Segment.Name = Name;
+    Segment.NameHash = GetTypeHash(Name);
+
+    FTCHARToUTF8 Utf8Name(*Name);
+    Segment.Utf8Name.Append(reinterpret_cast<const UTF8CHAR*>(Utf8Name.Get()), Utf8Name.Length());
+    return *this;
+}
+
+FJsonPathQuery& FJsonPathQuery::AddIndex(int32 Index) {
+    FJsonPathSegment& Segment = Segments.AddDefaulted_GetRef();
+    Segment.Kind = FJsonPathSegment::EKind::Index;
+    Segment.Index = Index;
+    return *this;
+}
+
+FJsonPathQuery& FJsonPathQuery::AddChildren() {
+    Segments.AddDefaulted_GetRef().Kind = FJsonPathSegment::EKind::Children;
+    return *this;
+}
+
+const FJsonValue* FJsonPathQuery::FindFirst(const FJsonObject& Root) const {
+    const FJsonValue* Found = nullptr;
+    if (bValid and Segments.Num() > 0) {
+        WalkDomObject(Segments, 0, Root, [&Found](const FJsonValue& Value) {
+            Found = &Value;
+            return false;
+            });
+    }
+    return Found;
+}
+
+int32 FJsonPathQuery::FindAll(const FJsonObject& Root, TArray<const FJsonValue*>& OutValues) const {
+    const int32 Before = OutValues.Num();
+    if (bValid and Segments.Num() > 0) {
+        WalkDomObject(Segments, 0, Root, [&OutValues](const FJsonValue& Value) {
+            OutValues.Add(&Value);
+            return true;
+            });
+    }
+    return OutValues.Num() - Before;
+}
+
+FJsonTapeValue FJsonPathQuery::FindFirst(FJsonTapeValue Root) const {
+    FJsonTapeValue Found;
+    if (bValid and Segments.Num() > 0 and Root.IsValid()) {
+        WalkTape(Segments, 0, Root, [&Found](FJsonTapeValue Value) {
+            Found = Value;
+            return false;
+            });
+    }
+    return Found;
+}
+
+int32 FJsonPathQuery::FindAll(FJsonTapeValue Root, TArray<FJsonTapeValue>& OutValues) const {
+    const int32 Before = OutValues.Num();
+    if (bValid and Segments.Num() > 0 and Root.IsValid()) {
+        WalkTape(Segments, 0, Root, [&OutValues](FJsonTapeValue Value) {
+            OutValues.Add(Value);
+            return true;
+            });
+    }
+    return OutValues.Num() - Before;
+}
+
+bool FJsonPathQuery::FindString(const FJsonObject& Root, FString& OutString) const {
+    const FJsonValue* Found = FindFirst(Root);
+    if (!Found or Found->Type != EJson::String) {
+        return false;
+    }
+    OutString = Found->AsString();
+    return true;
+}
+
+bool FJsonPathQuery::FindString(FJsonTapeValue Root, FString& OutString) const {
+    const FJsonTapeValue Found = FindFirst(Root);
+    if (!Found.IsString()) {
+        return false;
+    }
+    OutString = Found.AsString();
+    return true;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define JSON_SIMD_SCAN_SSE2 1
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#define JSON_SIMD_SCAN_NEON 1
+#endif
+
+#ifndef JSON_SIMD_SCAN_SSE2
+#define JSON_SIMD_SCAN_SSE2 0
+#endif
+#ifndef JSON_SIMD_SCAN_NEON
+#define JSON_SIMD_SCAN_NEON 0
+#endif
+
+// Scanners for the two hot loops of the tape parser, 16 bytes at a time where the CPU allows it.
+// Every function returns exactly the position its scalar twin does, Length when it runs off the end
+namespace JsonSimdScan {
+    constexpr bool bAvailable = JSON_SIMD_SCAN_SSE2 or JSON_SIMD_SCAN_NEON;
+
+    inline bool IsWhitespace(uint8 Byte) {
+        return Byte == ' ' or Byte == '\n' or Byte == '\r' or Byte == '\t';
+    }
+
+    // Bytes that end the plain run of a string: the closing quote, an escape or a control character
+    inline bool IsStringSpecial(uint8 Byte) {
+        return Byte == '"' or Byte == '\\' or Byte < 0x20;
+    }
+
+    inline int32 SkipWhitespaceScalar(const uint8* Bytes, int32 Cursor, int32 Length) {
+        while (Cursor < Length and IsWhitespace(Bytes[Cursor])) {
+            Cursor++;
+        }
+        return Cursor;
+    }
+
+    inline int32 FindStringSpecialScalar(const uint8* Bytes, int32 Cursor, int32 Length) {
+        while (Cursor < Length and !IsStringSpecial(Bytes[Cursor])) {
+            Cursor++;
+        }
+        return Cursor;
+    }
+
+#if JSON_SIMD_SCAN_NEON
+    // NEON has no movemask, narrowing leaves four bits per byte instead of one
+    inline uint64 NeonMask(uint8x16_t Mask) {
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Mask), 4)), 0);
+    }
+#endif
+
+    inline int32 SkipWhitespace(const uint8* Bytes, int32 Cursor, int32 Length) {
+        // Most gaps between tokens are empty or a single space, those never reach the vector loop
+        if (Cursor < Length and !IsWhitespace(Bytes[Cursor])) {
+            return Cursor;
+        }
+
+#if JSON_SIMD_SCAN_SSE2
+        const __m128i Space = _mm_set1_epi8(' ');
+        const __m128i Newline = _mm_set1_epi8('\n');
+        const __m128i Return = _mm_set1_epi8('\r');
+        const __m128i Tab = _mm_set1_epi8('\t');
+        for (; Cursor + 16 <= Length; Cursor += 16) {
+            const __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Bytes + Cursor));
+            const __m128i White = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(Chunk, Space), _mm_cmpeq_epi8(Chunk, Newline)),
+                _mm_or_si128(_mm_cmpeq_epi8(Chunk, Return), _mm_cmpeq_epi8(Chunk, Tab)));
+            const uint32 Mask = ~static_cast<uint32>(_mm_movemask_epi8(White)) & 0xFFFF;
+            if (Mask != 0) {
+                return Cursor + FMath::CountTrailingZeros(Mask);
+            }
+        }
+#elif JSON_SIMD_SCAN_NEON
+        const uint8x16_t Space = vdupq_n_u8(' ');
+        const uint8x16_t Newline = vdupq_n_u8('\n');
+        const uint8x16_t Return = vdupq_n_u8('\r');
+        const uint8x16_t Tab = vdupq_n_u8('\t');
+        for (; Cursor + 16 <= Length; Cursor += 16) {
+            const uint8x16_t Chunk = vld1q_u8(Bytes + Cursor);
+            const uint8x16_t White = vorrq_u8(vorrq_u8(vceqq_u8(Chunk, Space), vceqq_u8(Chunk, Newline)), vorrq_u8(vceqq_u8(Chunk, Return), vceqq_u8(Chunk, Tab)));
+            const uint64 Mask = NeonMask(vmvnq_u8(White));
+            if (Mask != 0) {
+                return Cursor + static_cast<int32>(FMath::CountTrailingZeros64(Mask) / 4);
+            }
+        }
+#endif
+        return SkipWhitespaceScalar(Bytes, Cursor, Length);
+    }
+
+    inline int32 FindStringSpecial(const uint8* Bytes, int32 Cursor, int32 Length) {
+#if JSON_SIMD_SCAN_SSE2
+        const __m128i Quote = _mm_set1_epi8('"');
+        const __m128i Backslash = _mm_set1_epi8('\\');
+        const __m128i LastControl = _mm_set1_epi8(0x1F);
+        for (; Cursor + 16 <= Length; Cursor += 16) {
+            const __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Bytes + Cursor));
+
+            // Unsigned Byte <= 0x1F, saturating subtraction leaves zero exactly there
+            const __m128i Control = _mm_cmpeq_epi8(_mm_subs_epu8(Chunk, LastControl), _mm_setzero_si128());
+            const __m128i Special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chunk, Quote), _mm_cmpeq_epi8(Chunk, Backslash)), Control);
+            const uint32 Mask = static_cast<uint32>(_mm_movemask_epi8(Special));
+            if (Mask != 0) {
+                return Cursor + FMath::CountTrailingZeros(Mask);
+            }
+        }
+#elif JSON_SIMD_SCAN_NEON
+        const uint8x16_t Quote = vdupq_n_u8('"');
+        const uint8x16_t Backslash = vdupq_n_u8('\\');
+        const uint8x16_t FirstPrintable = vdupq_n_u8(0x20);
+        for (; Cursor + 16 <= Length; Cursor += 16) {
+            const uint8x16_t Chunk = vld1q_u8(Bytes + Cursor);
+            const uint8x16_t Special = vorrq_u8(vorrq_u8(vceqq_u8(Chunk, Quote), vceqq_u8(Chunk, Backslash)), vcltq_u8(Chunk, FirstPrintable));
+            const uint64 Mask = NeonMask(Special);
+            if (Mask != 0) {
+                return Cursor + static_cast<int32>(FMath::CountTrailingZeros64(Mask) / 4);
+            }
+        }
+#endif
+        return FindStringSpecialScalar(Bytes, Cursor, Length);
+    }
+}
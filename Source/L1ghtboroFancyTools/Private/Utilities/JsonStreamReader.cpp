@@ -0,0 +1,425 @@
+#include "Utilities/JsonStreamReader.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Parse.h"
+
+FJsonStreamReader::FJsonStreamReader(IFileHandle& InFile, int32 ChunkSize) : File(&InFile) {
+    FileRemaining = FMath::Max<int64>(InFile.Size() - InFile.Tell(), 0);
+    ChunkStorage.SetNumUninitialized(FMath::Max(ChunkSize, 16));
+}
+
+FJsonStreamReader::FJsonStreamReader(TArrayView<const uint8> InBytes) : Chunk(InBytes) {
+}
+
+bool FJsonStreamReader::Refill() {
+    if (!File or FileRemaining == 0) {
+        return false;
+    }
+
+    ChunkOffset += Chunk.Num();
+    const int32 BytesToRead = static_cast<int32>(FMath::Min<int64>(ChunkStorage.Num(), FileRemaining));
+    if (!File->Read(ChunkStorage.GetData(), BytesToRead)) {
+        FileRemaining = 0;
+        Chunk = TArrayView<const uint8>();
+        Fail(TEXT("Read error"));
+        return false;
+    }
+
+    FileRemaining -= BytesToRead;
+    Chunk = TArrayView<const uint8>(ChunkStorage.GetData(), BytesToRead);
+    Position = 0;
+    return true;
+}
+
+bool FJsonStreamReader::PeekByte(uint8& OutByte) {
+    if (Position >= Chunk.Num() and !Refill()) {
+        return false;
+    }
+    OutByte = Chunk[Position];
+    return true;
+}
+
+bool FJsonStreamReader::NextByte(uint8& OutByte) {
+    if (!PeekByte(OutByte)) {
+        return false;
+    }
+    Position++;
+    return true;
+}
+
+bool FJsonStreamReader::NextToken(uint8& OutByte) {
+    while (NextByte(OutByte)) {
+        if (OutByte != ' ' and OutByte != '\t' and OutByte != '\n' and OutByte != '\r') {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FJsonStreamReader::Fail(const TCHAR* Message) {
+    if (ErrorMessage.IsEmpty()) {
+        ErrorMessage = Message;
+        ErrorOffset = ChunkOffset + Position;
+    }
+    return false;
+}
+
+bool FJsonStreamReader::Read(IJsonVisitor& Visitor) {
+    Stack.Reset();
+    State = EState::ExpectValue;
+    SkipDepth = INDEX_NONE;
+    bSkipNextValue = false;
+    bStopped = false;
+    ErrorMessage.Reset();
+
+    // Files saved by some editors start with a UTF-8 byte order mark
+    uint8 Byte = 0;
+    if (PeekByte(Byte) and Byte == 0xEF) {
+        uint8 Bom[3];
+        if (!NextByte(Bom[0]) or !NextByte(Bom[1]) or !NextByte(Bom[2]) or Bom[1] != 0xBB or Bom[2] != 0xBF) {
+            return Fail(TEXT("Invalid byte order mark"));
+        }
+    }
+
+    while (NextToken(Byte)) {
+        bool bKeepGoing = true;
+        switch (State) {
+        case EState::Done:
+            return Fail(TEXT("Unexpected data after the root value"));
+
+        case EState::ExpectValueOrArrayEnd:
+            if (Byte == ']') {
+                bKeepGoing = CloseContainer(false, Visitor);
+                break;
+            }
+            bKeepGoing = ParseValue(Byte, Visitor);
+            break;
+
+        case EState::ExpectValue:
+            bKeepGoing = ParseValue(Byte, Visitor);
+            break;
+
+        case EState::ExpectKeyOrObjectEnd:
+            if (Byte == '}') {
+                bKeepGoing = CloseContainer(true, Visitor);
+                break;
+            }
+            // Anything else has to be a key
+            [[fallthrough]];
+        case EState::ExpectKey: {
+            if (Byte != '"') {
+                return Fail(TEXT("Expected a key"));
+            }
+            const bool bSilent = IsSkipping();
+            if (!ParseString(!bSilent)) {
+                return false;
+            }
+            State = EState::ExpectColon;
+            if (!bSilent) {
+                const EJsonVisit Visit = Visitor.OnKey(StringValue);
+                bSkipNextValue = Visit == EJsonVisit::SkipValue;
+                bKeepGoing = Handle(Visit, false);
+            }
+            break;
+        }
+
+        case EState::ExpectColon:
+            if (Byte != ':') {
+                return Fail(TEXT("Expected ':' after a key"));
+            }
+            State = EState::ExpectValue;
+            break;
+
+        case EState::ExpectCommaOrEnd:
+            if (Byte == ',') {
+                State = Stack.Last() ? EState::ExpectKey : EState::ExpectValue;
+            }
+            else if (Byte == '}' or Byte == ']') {
+                bKeepGoing = CloseContainer(Byte == '}', Visitor);
+            }
+            else {
+                return Fail(TEXT("Expected ',' or the end of a container"));
+            }
+            break;
+        }
+
+        if (!bKeepGoing) {
+            return bStopped and ErrorMessage.IsEmpty();
+        }
+    }
+
+    if (!ErrorMessage.IsEmpty()) {
+        return false;
+    }
+    return State == EState::Done ? true : Fail(TEXT("Unexpected end of input"));
+}
+
+bool FJsonStreamReader::Handle(EJsonVisit Visit, bool bContainerStart) {
+    if (Visit == EJsonVisit::Stop) {
+        bStopped = true;
+        return false;
+    }
+
+    // Suppress everything until the container that just opened is closed again
+    if (Visit == EJsonVisit::SkipValue and bContainerStart) {
+        SkipDepth = Stack.Num() - 1;
+    }
+    return true;
+}
+
+bool FJsonStreamReader::ParseValue(uint8 First, IJsonVisitor& Visitor) {
+    const bool bSilent = IsSkipping() or bSkipNextValue;
+    bSkipNextValue = false;
+
+    switch (First) {
+    case '{':
+    case '[':
+        return OpenContainer(First == '{', bSilent, Visitor);
+
+    case '"':
+        if (!ParseString(!bSilent)) {
+            return false;
+        }
+        FinishValue();
+        return bSilent or Handle(Visitor.OnString(StringValue), false);
+
+    case 't':
+        if (!ParseLiteral("rue")) {
+            return false;
+        }
+        FinishValue();
+        return bSilent or Handle(Visitor.OnBool(true), false);
+
+    case 'f':
+        if (!ParseLiteral("alse")) {
+            return false;
+        }
+        FinishValue();
+        return bSilent or Handle(Visitor.OnBool(false), false);
+
+    case 'n':
+        if (!ParseLiteral("ull")) {
+            return false;
+        }
+        FinishValue();
+        return bSilent or Handle(Visitor.OnNull(), false);
+
+    default: {
+        double Number = 0.0;
+        if (!ParseNumber(First, Number)) {
+            return false;
+        }
+        FinishValue();
+        return bSilent or Handle(Visitor.OnNumber(Number), false);
+    }
+    }
+}
+
+bool FJsonStreamReader::OpenContainer(bool bObject, bool bSilent, IJsonVisitor& Visitor) {
+    if (Stack.Num() >= MaxDepth) {
+        return Fail(TEXT("Nesting is too deep"));
+    }
+
+    Stack.Add(bObject);
+    State = bObject ? EState::ExpectKeyOrObjectEnd : EState::ExpectValueOrArrayEnd;
+
+    if (bSilent) {
+        // A value skipped through its key starts a skip of its own, nested containers of a skipped one do not
+        if (!IsSkipping()) {
+            SkipDepth = Stack.Num() - 1;
+        }
+        return true;
+    }
+    return Handle(bObject ? Visitor.OnObjectStart() : Visitor.OnArrayStart(), true);
+}
+
+bool FJsonStreamReader::CloseContainer(bool bObject, IJsonVisitor& Visitor) {
+    if (Stack.Num() == 0 or Stack.Last() != bObject) {
+        return Fail(TEXT("Mismatched end of container"));
+    }
+
+    const bool bSilent = IsSkipping();
+    Stack.Pop(false);
+    if (SkipDepth == Stack.Num()) {
+        SkipDepth = INDEX_NONE;
+    }
+    FinishValue();
+
+    if (bSilent) {
+        return true;
+    }
+    return Handle(bObject ? Visitor.OnObjectEnd() : Visitor.OnArrayEnd(), false);
+}
+
+bool FJsonStreamReader::ParseString(bool bDecode) {
+    StringBytes.Reset();
+
+    uint8 Byte = 0;
+    for (;;) {
+        if (!NextByte(Byte)) {
+            return Fail(TEXT("Unterminated string"));
+        }
+        if (Byte == '"') {
+            break;
+        }
+        if (Byte < 0x20) {
+            return Fail(TEXT("Control character in string"));
+        }
+        if (Byte != '\\') {
+            if (bDecode) {
+                StringBytes.Add(static_cast<UTF8CHAR>(Byte));
+            }
+            continue;
+        }
+
+        if (!NextByte(Byte)) {
+            return Fail(TEXT("Unterminated escape sequence"));
+        }
+
+        uint8 Escaped = 0;
+        switch (Byte) {
+        case '"':  Escaped = '"'; break;
+        case '\\': Escaped = '\\'; break;
+        case '/':  Escaped = '/'; break;
+        case 'b':  Escaped = '\b'; break;
+        case 'f':  Escaped = '\f'; break;
+        case 'n':  Escaped = '\n'; break;
+        case 'r':  Escaped = '\r'; break;
+        case 't':  Escaped = '\t'; break;
+        case 'u': {
+            uint32 CodePoint = 0;
+            if (!ReadHexQuad(CodePoint)) {
+                return false;
+            }
+
+            // High surrogate, the low half has to follow as another \u escape
+            if (CodePoint >= 0xD800 and CodePoint <= 0xDBFF) {
+                uint8 Backslash = 0;
+                uint8 U = 0;
+                uint32 LowSurrogate = 0;
+                if (!NextByte(Backslash) or !NextByte(U) or Backslash != '\\' or U != 'u' or !ReadHexQuad(LowSurrogate) or LowSurrogate < 0xDC00 or LowSurrogate > 0xDFFF) {
+                    return Fail(TEXT("Unpaired surrogate in string"));
+                }
+                CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+            }
+            if (bDecode) {
+                AppendCodePoint(CodePoint);
+            }
+            continue;
+        }
+        default:
+            return Fail(TEXT("Invalid escape sequence"));
+        }
+
+        if (bDecode) {
+            StringBytes.Add(static_cast<UTF8CHAR>(Escaped));
+        }
+    }
+
+    StringValue.Reset();
+    if (bDecode and StringBytes.Num() > 0) {
+        FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StringBytes.GetData()), StringBytes.Num());
+        StringValue.AppendChars(Converted.Get(), Converted.Length());
+    }
+    return true;
+}
+
+bool FJsonStreamReader::ReadHexQuad(uint32& OutCodePoint) {
+    OutCodePoint = 0;
+    for (int32 Digit = 0; Digit < 4; Digit++) {
+        uint8 Byte = 0;
+        if (!NextByte(Byte) or !FChar::IsHexDigit(static_cast<TCHAR>(Byte))) {
+            return Fail(TEXT("Invalid \\u escape"));
+        }
+        OutCodePoint = (OutCodePoint << 4) | FParse::HexDigit(static_cast<TCHAR>(Byte));
+    }
+    return true;
+}
+
+void FJsonStreamReader::AppendCodePoint(uint32 CodePoint) {
+    if (CodePoint < 0x80) {
+        StringBytes.Add(static_cast<UTF8CHAR>(CodePoint));
+    }
+    else if (CodePoint < 0x800) {
+        StringBytes.Add(static_cast<UTF8CHAR>(0xC0 | (CodePoint >> 6)));
+        StringBytes.Add(static_cast<UTF8CHAR>(0x80 | (CodePoint & 0x3F)));
+    }
+    else if (CodePoint < 0x10000) {
+        StringBytes.Add(static_cast<UTF8CHAR>(0xE0 | (CodePoint >> 12)));
+        StringBytes.Add(static_cast<UTF8CHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+        StringBytes.Add(static_cast<UTF8CHAR>(0x80 | (CodePoint & 0x3F)));
+    }
+    else {
+        StringBytes.Add(static_cast<UTF8CHAR>(0xF0 | (CodePoint >> 18)));
+        StringBytes.Add(static_cast<UTF8CHAR>(0x80 | ((CodePoint >> 12) & 0x3F)));
+        StringBytes.Add(static_cast<UTF8CHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+        StringBytes.Add(static_cast<UTF8CHAR>(0x80 | (CodePoint & 0x3F)));
+    }
+}
+
+bool FJsonStreamReader::ParseNumber(uint8 First, double& OutValue) {
+    // Longest number we accept, plenty for any double written out in full
+    ANSICHAR Text[128];
+    int32 Length = 0;
+    Text[Length++] = static_cast<ANSICHAR>(First);
+
+    uint8 Byte = 0;
+    while (PeekByte(Byte) and (FChar::IsDigit(static_cast<TCHAR>(Byte)) or Byte == '.' or Byte == 'e' or Byte == 'E' or Byte == '+' or Byte == '-')) {
+        if (Length == UE_ARRAY_COUNT(Text) - 1) {
+            return Fail(TEXT("Number is too long"));
+        }
+        Text[Length++] = static_cast<ANSICHAR>(Byte);
+        Position++;
+    }
+    Text[Length] = '\0';
+
+    // Validate against the JSON grammar: -?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?
+    int32 Index = 0;
+    auto SkipDigits = [&Text, &Index]() {
+        const int32 Start = Index;
+        while (FCharAnsi::IsDigit(Text[Index])) {
+            Index++;
+        }
+        return Index - Start;
+        };
+
+    if (Text[Index] == '-') {
+        Index++;
+    }
+    if (Text[Index] == '0') {
+        Index++;
+    }
+    else if (SkipDigits() == 0) {
+        return Fail(TEXT("Invalid value"));
+    }
+    if (Text[Index] == '.') {
+        Index++;
+        if (SkipDigits() == 0) {
+            return Fail(TEXT("Invalid number"));
+        }
+    }
+    if (Text[Index] == 'e' or Text[Index] == 'E') {
+        Index++;
+        if (Text[Index] == '+' or Text[Index] == '-') {
+            Index++;
+        }
+        if (SkipDigits() == 0) {
+            return Fail(TEXT("Invalid number"));
+        }
+    }
+    if (Index != Length) {
+        return Fail(TEXT("Invalid number"));
+    }
+
+    OutValue = FCStringAnsi::Atod(Text);
+    return true;
+}
+
+bool FJsonStreamReader::ParseLiteral(const char* Rest) {
+    for (; *Rest; Rest++) {
+        uint8 Byte = 0;
+        if (!NextByte(Byte) or Byte != static_cast<uint8>(*Rest)) {
+            return Fail(TEXT("Invalid literal"));
+        }
+    }
+    return true;
+}
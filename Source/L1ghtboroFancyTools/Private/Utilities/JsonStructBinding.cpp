@@ -0,0 +1,352 @@
+#include "Utilities/JsonStructBinding.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UObjectGlobals.h"
+
+FRWLock FJsonStructBinding::FieldMapsLock;
+TMap<TObjectKey<UScriptStruct>, TSharedRef<const FJsonStructFieldMap>> FJsonStructBinding::FieldMaps;
+
+namespace {
+    UTF8CHAR ToLowerAscii(UTF8CHAR Char) {
+        return Char >= 'A' and Char <= 'Z' ? static_cast<UTF8CHAR>(Char + ('a' - 'A')) : Char;
+    }
+
+    bool EqualsLowered(TConstArrayView<UTF8CHAR> Lowered, FUtf8StringView Key) {
+        if (Lowered.Num() != Key.Len()) {
+            return false;
+        }
+        for (int32 Index = 0; Index < Key.Len(); Index++) {
+            if (Lowered[Index] != ToLowerAscii(Key[Index])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Doubles outside the int64 range, NaN included, have no defined conversion
+    bool NumberToInt64(double Number, int64& OutValue) {
+        if (!(Number >= -9223372036854775808.0 and Number < 9223372036854775808.0)) {
+            return false;
+        }
+        OutValue = static_cast<int64>(Number);
+        return true;
+    }
+
+    // Value of a set element or map key, bound here first so the container hashes it only once it is complete
+    class FScratchValue {
+    public:
+        explicit FScratchValue(const FProperty* InProperty)
+            : Property(InProperty), Data(FMemory::Malloc(InProperty->GetSize(), InProperty->GetMinAlignment())) {
+            Property->InitializeValue(Data);
+        }
+        ~FScratchValue() {
+            Property->DestroyValue(Data);
+            FMemory::Free(Data);
+        }
+        FScratchValue(const FScratchValue&) = delete;
+        FScratchValue& operator=(const FScratchValue&) = delete;
+
+        void Reset() {
+            Property->DestroyValue(Data);
+            Property->InitializeValue(Data);
+        }
+        void* Get() const { return Data; }
+
+    private:
+        const FProperty* Property;
+        void* Data;
+    };
+}
+
+uint32 FJsonStructFieldMap::HashKey(FUtf8StringView Key) {
+    // FNV-1a over lower cased bytes, so the raw key from the tape can be hashed in place
+    uint32 Hash = 2166136261u;
+    for (UTF8CHAR Char : Key) {
+        Hash = (Hash ^ static_cast<uint8>(ToLowerAscii(Char))) * 16777619u;
+    }
+    return Hash;
+}
+
+FJsonStructFieldMap::FJsonStructFieldMap(const UScriptStruct* Struct) : FirstProperty(Struct->ChildProperties), StructureSize(Struct->GetStructureSize()) {
+    for (TFieldIterator<FProperty> It(Struct); It; ++It) {
+        FJsonStructField& Field = Fields.AddDefaulted_GetRef();
+        Field.Property = *It;
+
+        // Authored name, so user defined structs match on what their author typed and not the mangled name
+        FTCHARToUTF8 Utf8Name(*It->GetAuthoredName());
+        Field.Name.Reserve(Utf8Name.Length());
+        for (int32 Index = 0; Index < Utf8Name.Length(); Index++) {
+            Field.Name.Add(ToLowerAscii(static_cast<UTF8CHAR>(Utf8Name.Get()[Index])));
+        }
+        Field.Hash = HashKey(FUtf8StringView(Field.Name.GetData(), Field.Name.Num()));
+    }
+
+    // Chain fields sharing a hash, the first one lives in the map
+    for (int32 Index = Fields.Num() - 1; Index >= 0; Index--) {
+        int32& Head = Buckets.FindOrAdd(Fields[Index].Hash, INDEX_NONE);
+        Fields[Index].NextInBucket = Head;
+        Head = Index;
+    }
+}
+
+const FJsonStructField* FJsonStructFieldMap::Find(FUtf8StringView Key) const {
+    const int32* Head = Buckets.Find(HashKey(Key));
+    for (int32 Index = Head ? *Head : INDEX_NONE; Index != INDEX_NONE; Index = Fields[Index].NextInBucket) {
+        if (EqualsLowered(Fields[Index].Name, Key)) {
+            return &Fields[Index];
+        }
+    }
+    return nullptr;
+}
+
+bool FJsonStructFieldMap::MatchesLayout(const UScriptStruct* Struct) const {
+    return Struct->ChildProperties == FirstProperty and Struct->GetStructureSize() == StructureSize;
+}
+
+TSharedRef<const FJsonStructFieldMap> FJsonStructBinding::GetFieldMap(const UScriptStruct* Struct) {
+    static const bool bRegistered = (RegisterInvalidation(), true);
+
+    const TObjectKey<UScriptStruct> Key(Struct);
+    {
+        FReadScopeLock ReadLock(FieldMapsLock);
+        const TSharedRef<const FJsonStructFieldMap>* Found = FieldMaps.Find(Key);
+        if (Found and (*Found)->MatchesLayout(Struct)) {
+            return *Found;
+        }
+    }
+
+    // Built outside the lock, a racing thread may have added the same struct meanwhile
+    TSharedRef<const FJsonStructFieldMap> Built = MakeShared<FJsonStructFieldMap>(Struct);
+
+    FWriteScopeLock WriteLock(FieldMapsLock);
+    const TSharedRef<const FJsonStructFieldMap>* Found = FieldMaps.Find(Key);
+    if (Found and (*Found)->MatchesLayout(Struct)) {
+        return *Found;
+    }
+    FieldMaps.Add(Key, Built);
+    return Built;
+}
+
+void FJsonStructBinding::RegisterInvalidation() {
+    FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) {
+        ResetFieldMaps();
+        });
+#if WITH_EDITOR
+    FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) {
+        ResetFieldMaps();
+        });
+#endif
+}
+
+void FJsonStructBinding::ResetFieldMaps() {
+    FWriteScopeLock WriteLock(FieldMapsLock);
+    FieldMaps.Reset();
+}
+
+bool FJsonStructBinding::BindStruct(FJsonTapeValue Object, const UScriptStruct* Struct, void* StructData) {
+    if (!Struct or !StructData or !Object.IsObject()) {
+        return false;
+    }
+
+    const TSharedRef<const FJsonStructFieldMap> FieldMap = GetFieldMap(Struct);
+    bool bSuccess = true;
+    Object.ForEachField([&FieldMap, StructData, &bSuccess](FJsonTapeValue Key, FJsonTapeValue Value) {
+        const FJsonStructField* Field = Key.IsPlainString() ? FieldMap->Find(Key.AsRawString()) : nullptr;
+
+        // Keys with escapes are rare enough to decode
+        if (!Field and !Key.IsPlainString()) {
+            FTCHARToUTF8 Decoded(*Key.AsString());
+            Field = FieldMap->Find(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Decoded.Get()), Decoded.Length()));
+        }
+        if (Field and !BindProperty(Value, Field->Property, Field->Property->ContainerPtrToValuePtr<void>(StructData))) {
+            UE_LOG(LogTemp, Warning, TEXT("JSON field '%s' does not fit property %s"), *Key.AsString(), *Field->Property->GetName());
+            bSuccess = false;
+        }
+        return true;
+        });
+    return bSuccess;
+}
+
+bool FJsonStructBinding::BindProperty(FJsonTapeValue Value, FProperty* Property, void* PropertyData) {
+    if (Property->ArrayDim == 1) {
+        return BindValue(Value, Property, PropertyData);
+    }
+
+    // C style array, filled from a JSON array up to its fixed size
+    if (!Value.IsArray()) {
+        return false;
+    }
+    bool bSuccess = true;
+    int32 ElementIndex = 0;
+    Value.ForEachElement([Property, PropertyData, &ElementIndex, &bSuccess](FJsonTapeValue Element) {
+        bSuccess &= BindValue(Element, Property, static_cast<uint8*>(PropertyData) + ElementIndex * Property->ElementSize);
+        return ++ElementIndex < Property->ArrayDim;
+        });
+    return bSuccess;
+}
+
+bool FJsonStructBinding::BindValue(FJsonTapeValue Value, FProperty* Property, void* ValueData) {
+    // Null leaves the default value, like a missing field
+    if (Value.IsNull()) {
+        return true;
+    }
+
+    if (FStrProperty* StrProperty = CastField<FStrProperty>(Property)) {
+        if (!Value.IsString()) {
+            return false;
+        }
+        StrProperty->SetPropertyValue(ValueData, Value.AsString());
+        return true;
+    }
+
+    if (FNameProperty* NameProperty = CastField<FNameProperty>(Property)) {
+        if (!Value.IsString()) {
+            return false;
+        }
+        NameProperty->SetPropertyValue(ValueData, FName(Value.AsString()));
+        return true;
+    }
+
+    if (FTextProperty* TextProperty = CastField<FTextProperty>(Property)) {
+        if (!Value.IsString()) {
+            return false;
+        }
+        TextProperty->SetPropertyValue(ValueData, FText::FromString(Value.AsString()));
+        return true;
+    }
+
+    if (FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property)) {
+        if (!Value.IsBool()) {
+            return false;
+        }
+        BoolProperty->SetPropertyValue(ValueData, Value.AsBool());
+        return true;
+    }
+
+    if (FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property)) {
+        int64 EnumValue = 0;
+        if (Value.IsString()) {
+            EnumValue = EnumProperty->GetEnum()->GetValueByNameString(Value.AsString());
+            if (EnumValue == INDEX_NONE) {
+                return false;
+            }
+        }
+        else if (Value.IsNumber()) {
+            if (!NumberToInt64(Value.AsNumber(), EnumValue)) {
+                return false;
+            }
+        }
+        else {
+            return false;
+        }
+        EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(ValueData, EnumValue);
+        return true;
+    }
+
+    if (FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property)) {
+        // Byte properties backed by an enum take the enumerator name as well
+        if (Value.IsString() and NumericProperty->GetIntPropertyEnum()) {
+            const int64 EnumValue = NumericProperty->GetIntPropertyEnum()->GetValueByNameString(Value.AsString());
+            if (EnumValue == INDEX_NONE) {
+                return false;
+            }
+            NumericProperty->SetIntPropertyValue(ValueData, EnumValue);
+            return true;
+        }
+        if (!Value.IsNumber()) {
+            return false;
+        }
+        if (NumericProperty->IsFloatingPoint()) {
+            NumericProperty->SetFloatingPointPropertyValue(ValueData, Value.AsNumber());
+        }
+        else {
+            int64 IntValue = 0;
+            if (!NumberToInt64(Value.AsNumber(), IntValue)) {
+                return false;
+            }
+            NumericProperty->SetIntPropertyValue(ValueData, IntValue);
+        }
+        return true;
+    }
+
+    if (FStructProperty* StructProperty = CastField<FStructProperty>(Property)) {
+        return BindStruct(Value, StructProperty->Struct, ValueData);
+    }
+
+    if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property)) {
+        if (!Value.IsArray()) {
+            return false;
+        }
+
+        // Sized once up front, Num is exact below 16M elements
+        FScriptArrayHelper Helper(ArrayProperty, ValueData);
+        Helper.EmptyAndAddValues(Value.Num());
+        bool bSuccess = true;
+        int32 ElementIndex = 0;
+        Value.ForEachElement([ArrayProperty, &Helper, &ElementIndex, &bSuccess](FJsonTapeValue Element) {
+            if (ElementIndex >= Helper.Num()) {
+                Helper.AddValue();
+            }
+            bSuccess &= BindValue(Element, ArrayProperty->Inner, Helper.GetRawPtr(ElementIndex++));
+            return true;
+            });
+        return bSuccess;
+    }
+
+    if (FSetProperty* SetProperty = CastField<FSetProperty>(Property)) {
+        if (!Value.IsArray()) {
+            return false;
+        }
+
+        // Duplicates collapse into one element, elements that fail to bind are left out
+        FScriptSetHelper Helper(SetProperty, ValueData);
+        Helper.EmptyElements(Value.Num());
+        FScratchValue Element(SetProperty->ElementProp);
+        bool bSuccess = true;
+        Value.ForEachElement([SetProperty, &Helper, &Element, &bSuccess](FJsonTapeValue ElementValue) {
+            Element.Reset();
+            if (BindValue(ElementValue, SetProperty->ElementProp, Element.Get())) {
+                Helper.AddElement(Element.Get());
+            }
+            else {
+                bSuccess = false;
+            }
+            return true;
+            });
+        return bSuccess;
+    }
+
+    if (FMapProperty* MapProperty = CastField<FMapProperty>(Property)) {
+        if (!Value.IsObject()) {
+            return false;
+        }
+
+        // JSON keys are strings, the key property imports them from text. Keys that fail to import
+        // are left out, and keys that end up equal, like names differing only in case, keep the last value
+        FScriptMapHelper Helper(MapProperty, ValueData);
+        Helper.EmptyValues(Value.Num());
+        FScratchValue PairKey(MapProperty->KeyProp);
+        FScratchValue PairValue(MapProperty->ValueProp);
+        bool bSuccess = true;
+        Value.ForEachField([MapProperty, &Helper, &PairKey, &PairValue, &bSuccess](FJsonTapeValue Key, FJsonTapeValue MapValue) {
+            PairKey.Reset();
+            const FString KeyString = Key.AsString();
+            if (!MapProperty->KeyProp->ImportText_Direct(*KeyString, PairKey.Get(), nullptr, PPF_None)) {
+                bSuccess = false;
+                return true;
+            }
+            PairValue.Reset();
+            bSuccess &= BindValue(MapValue, MapProperty->ValueProp, PairValue.Get());
+            Helper.AddPair(PairKey.Get(), PairValue.Get());
+            return true;
+            });
+        return bSuccess;
+    }
+
+    // Object and class references, soft paths and anything else with a text form
+    if (Value.IsString()) {
+        return Property->ImportText_Direct(*Value.AsString(), ValueData, nullptr, PPF_None) != nullptr;
+    }
+    return false;
+}
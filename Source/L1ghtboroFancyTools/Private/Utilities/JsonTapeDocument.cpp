@@ -0,0 +1,897 @@
+#include "Utilities/JsonTapeDocument.h"
+#include "Utilities/JsonSimdScan.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarJsonSimdScan(
+    TEXT("Json.SimdScan"),
+    true,
+    TEXT("Scan whitespace and string contents 16 bytes at a time with SSE2 or NEON while parsing JSON. No effect on other CPUs."),
+    ECVF_Default);
+
+namespace {
+    constexpr uint32 CookedMagic = 0x424E534A; // "JSNB"
+    constexpr uint32 CookedVersion = 2;
+
+    // Followed by the tape words and the string bytes, keeps the words 8 byte aligned
+    struct FJsonCookedHeader {
+        uint32 Magic;
+        uint32 Version;
+        uint32 KeyCount;
+        uint32 Reserved;
+        uint64 WordCount;
+        uint64 StringBytes;
+
+        // Size and modification time of the text file the document was cooked from, -1 and 0 when unknown
+        int64 SourceSize;
+        int64 SourceTicks;
+    };
+    static_assert(sizeof(FJsonCookedHeader) == 48, "Cooked header layout changed");
+
+    constexpr uint32 CompressedMagic = 0x5A4E534A; // "JSNZ"
+    constexpr uint32 CompressedVersion = 1;
+
+    // Followed by the zlib stream
+    struct FJsonCompressedHeader {
+        uint32 Magic;
+        uint32 Version;
+        uint64 UncompressedSize;
+    };
+    static_assert(sizeof(FJsonCompressedHeader) == FJsonTapeDocument::CompressedHeaderSize, "Compressed header layout changed");
+
+    void AppendUtf8(FString& Result, const UTF8CHAR* Bytes, int32 Length) {
+        if (Length > 0) {
+            FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes), Length);
+            Result.AppendChars(Converted.Get(), Converted.Length());
+        }
+    }
+}
+
+EJsonTapeType FJsonTapeValue::GetType() const {
+    return IsValid() ? Document->GetWordType(Index) : EJsonTapeType::Invalid;
+}
+
+double FJsonTapeValue::AsNumber(double Default) const {
+    if (!IsNumber()) {
+        return Default;
+    }
+    double Value = 0.0;
+    FMemory::Memcpy(&Value, &Document->Words[Index + 1], sizeof(double));
+    return Value;
+}
+
+bool FJsonTapeValue::AsBool(bool bDefault) const {
+    const EJsonTapeType Type = GetType();
+    return Type == EJsonTapeType::True ? true : Type == EJsonTapeType::False ? false : bDefault;
+}
+
+FUtf8StringView FJsonTapeValue::AsRawString() const {
+    if (!IsString()) {
+        return FUtf8StringView();
+    }
+    const uint64 Offset = Document->GetWordPayload(Index);
+    const int32 Length = static_cast<int32>(Document->Words[Index + 1] & ~FJsonTapeDocument::EscapedBit);
+    return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Document->Source.GetData() + Offset), Length);
+}
+
+bool FJsonTapeValue::IsPlainString() const {
+    return IsString() and (Document->Words[Index + 1] & FJsonTapeDocument::EscapedBit) == 0;
+}
+
+FString FJsonTapeValue::AsString() const {
+    const FUtf8StringView Raw = AsRawString();
+    FString Result;
+    if (IsPlainString()) {
+        AppendUtf8(Result, Raw.GetData(), Raw.Len());
+        return Result;
+    }
+
+    // Escapes were validated while parsing. \u escapes append UTF-16 code units like TJsonReader does
+    Result.Reserve(Raw.Len());
+    int32 RunStart = 0;
+    for (int32 At = 0; At < Raw.Len(); At++) {
+        if (Raw[At] != '\\') {
+            continue;
+        }
+        AppendUtf8(Result, Raw.GetData() + RunStart, At - RunStart);
+
+        const UTF8CHAR Escape = Raw[++At];
+        switch (Escape) {
+        case 'b': Result.AppendChar(TEXT('\b')); break;
+        case 'f': Result.AppendChar(TEXT('\f')); break;
+        case 'n': Result.AppendChar(TEXT('\n')); break;
+        case 'r': Result.AppendChar(TEXT('\r')); break;
+        case 't': Result.AppendChar(TEXT('\t')); break;
+        case 'u': {
+            uint32 CodeUnit = 0;
+            for (int32 Digit = 1; Digit <= 4; Digit++) {
+                CodeUnit = (CodeUnit << 4) | FParse::HexDigit(static_cast<TCHAR>(Raw[At + Digit]));
+            }
+            Result.AppendChar(static_cast<TCHAR>(CodeUnit));
+            At += 4;
+            break;
+        }
+        default: Result.AppendChar(static_cast<TCHAR>(Escape)); break;
+        }
+        RunStart = At + 1;
+    }
+    AppendUtf8(Result, Raw.GetData() + RunStart, Raw.Len() - RunStart);
+    return Result;
+}
+
+bool FJsonTapeValue::StringEquals(FUtf8StringView Other) const {
+    if (IsPlainString()) {
+        const FUtf8StringView Raw = AsRawString();
+        return Raw.Len() == Other.Len() and FMemory::Memcmp(Raw.GetData(), Other.GetData(), Raw.Len()) == 0;
+    }
+    if (!IsString()) {
+        return false;
+    }
+
+    // Rare, escaped keys are decoded to compare
+    FString OtherString;
+    AppendUtf8(OtherString, Other.GetData(), Other.Len());
+    return AsString().Equals(OtherString, ESearchCase::CaseSensitive);
+}
+
+int32 FJsonTapeValue::Num() const {
+    if (!IsObject() and !IsArray()) {
+        return 0;
+    }
+    return static_cast<int32>((Document->GetWordPayload(Index) >> 32) & FJsonTapeDocument::MaxChildCount);
+}
+
+int32 FJsonTapeValue::GetNextIndex() const {
+    switch (GetType()) {
+    case EJsonTapeType::String:
+    case EJsonTapeType::Number:
+        return Index + 2;
+    case EJsonTapeType::ObjectStart:
+    case EJsonTapeType::ArrayStart:
+        return static_cast<int32>(Document->GetWordPayload(Index) & MAX_uint32);
+    default:
+        return Index + 1;
+    }
+}
+
+FJsonTapeValue FJsonTapeValue::FindField(FUtf8StringView Key) const {
+    FJsonTapeValue Found;
+    ForEachField([&Found, Key](FJsonTapeValue FieldKey, FJsonTapeValue Value) {
+        if (FieldKey.StringEquals(Key)) {
+            Found = Value;
+            return false;
+        }
+        return true;
+        });
+    return Found;
+}
+
+FJsonTapeValue FJsonTapeValue::FindField(FStringView Key) const {
+    FTCHARToUTF8 Utf8Key(Key.GetData(), Key.Len());
+    return FindField(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Utf8Key.Get()), Utf8Key.Length()));
+}
+
+FJsonTapeValue FJsonTapeValue::GetElement(int32 ElementIndex) const {
+    FJsonTapeValue Found;
+    int32 Position = 0;
+    ForEachElement([&Found, &Position, ElementIndex](FJsonTapeValue Element) {
+        if (Position++ == ElementIndex) {
+            Found = Element;
+            return false;
+        }
+        return true;
+        });
+    return Found;
+}
+
+void FJsonTapeValue::ForEachField(TFunctionRef<bool(FJsonTapeValue Key, FJsonTapeValue Value)> Visitor) const {
+    if (!IsObject()) {
+        return;
+    }
+
+    // Children end at the matching ObjectEnd, one word before the next index
+    const int32 End = GetNextIndex() - 1;
+    for (int32 At = Index + 1; At < End;) {
+        const FJsonTapeValue Key(Document, At);
+        const FJsonTapeValue Value(Document, At + 2);
+        if (!Visitor(Key, Value)) {
+            return;
+        }
+        At = Value.GetNextIndex();
+    }
+}
+
+void FJsonTapeValue::ForEachElement(TFunctionRef<bool(FJsonTapeValue Element)> Visitor) const {
+    if (!IsArray()) {
+        return;
+    }
+
+    const int32 End = GetNextIndex() - 1;
+    for (int32 At = Index + 1; At < End;) {
+        const FJsonTapeValue Element(Document, At);
+        if (!Visitor(Element)) {
+            return;
+        }
+        At = Element.GetNextIndex();
+    }
+}
+
+TSharedPtr<FJsonValue> FJsonTapeValue::ToJsonValue() const {
+    switch (GetType()) {
+    case EJsonTapeType::Null:
+        return MakeShared<FJsonValueNull>();
+    case EJsonTapeType::True:
+    case EJsonTapeType::False:
+        return MakeShared<FJsonValueBoolean>(AsBool());
+    case EJsonTapeType::Number:
+        return MakeShared<FJsonValueNumber>(AsNumber());
+    case EJsonTapeType::String:
+        return MakeShared<FJsonValueString>(AsString());
+    case EJsonTapeType::ObjectStart:
+        return MakeShared<FJsonValueObject>(ToJsonObject());
+    case EJsonTapeType::ArrayStart: {
+        TArray<TSharedPtr<FJsonValue>> Elements;
+        Elements.Reserve(Num());
+        ForEachElement([&Elements](FJsonTapeValue Element) {
+            Elements.Add(Element.ToJsonValue());
+            return true;
+            });
+        return MakeShared<FJsonValueArray>(MoveTemp(Elements));
+    }
+    default:
+        return nullptr;
+    }
+}
+
+TSharedPtr<FJsonObject> FJsonTapeValue::ToJsonObject() const {
+    if (!IsObject()) {
+        return nullptr;
+    }
+
+    TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+    Object->Values.Reserve(Num());
+    ForEachField([&Object](FJsonTapeValue Key, FJsonTapeValue Value) {
+        Object->SetField(Key.AsString(), Value.ToJsonValue());
+        return true;
+        });
+    return Object;
+}
+
+FJsonTapeDocument::FJsonTapeDocument() = default;
+
+FJsonTapeDocument::~FJsonTapeDocument() {
+    Reset();
+}
+
+void FJsonTapeDocument::Reset() {
+    // The region has to go before the handle it was mapped from
+    MappedRegion.Reset();
+    MappedFile.Reset();
+    OwnedBytes.Empty();
+    Source = TArrayView<const uint8>();
+    Tape.Empty();
+    Words = TConstArrayView<uint64>();
+    ErrorMessage.Reset();
+    ErrorOffset = 0;
+    CookedSourceSize = INDEX_NONE;
+    CookedSourceTicks = 0;
+}
+
+bool FJsonTapeDocument::IsCookedFrom(int64 SourceSize, const FDateTime& SourceTimestamp) const {
+    return CookedSourceSize >= 0 and CookedSourceSize == SourceSize and CookedSourceTicks == SourceTimestamp.GetTicks();
+}
+
+SIZE_T FJsonTapeDocument::GetAllocatedSize() const {
+    return Tape.GetAllocatedSize() + OwnedBytes.GetAllocatedSize() + ErrorMessage.GetAllocatedSize();
+}
+
+bool FJsonTapeDocument::LoadFile(const FString& AbsoluteFilePath) {
+    Reset();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    MappedFile.Reset(PlatformFile.OpenMapped(*AbsoluteFilePath));
+    if (MappedFile and MappedFile->GetFileSize() > 0 and MappedFile->GetFileSize() < MAX_int32) {
+        MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize(), true));
+    }
+    if (MappedRegion) {
+        Source = TArrayView<const uint8>(MappedRegion->GetMappedPtr(), static_cast<int32>(MappedRegion->GetMappedSize()));
+        return Parse();
+    }
+
+    // No mapping on this platform or for files inside a pak, read everything into a single buffer instead
+    MappedFile.Reset();
+    if (!FFileHelper::LoadFileToArray(OwnedBytes, *AbsoluteFilePath, FILEREAD_Silent)) {
+        return Fail(TEXT("Could not read the file"), 0);
+    }
+    Source = OwnedBytes;
+    return Parse();
+}
+
+bool FJsonTapeDocument::ParseBytes(TArray<uint8>&& Bytes) {
+    Reset();
+    OwnedBytes = MoveTemp(Bytes);
+    Source = OwnedBytes;
+    return Parse();
+}
+
+bool FJsonTapeDocument::ParseView(TArrayView<const uint8> Bytes) {
+    Reset();
+    Source = Bytes;
+    return Parse();
+}
+
+bool FJsonTapeDocument::Fail(const TCHAR* Message, int64 Offset) {
+    Tape.Reset();
+    Words = TConstArrayView<uint64>();
+    ErrorMessage = Message;
+    ErrorOffset = Offset;
+    return false;
+}
+
+int32 FJsonTapeDocument::SkipWhitespace(int32 Cursor) const {
+    return bSimdScan ? JsonSimdScan::SkipWhitespace(Source.GetData(), Cursor, Source.Num()) : JsonSimdScan::SkipWhitespaceScalar(Source.GetData(), Cursor, Source.Num());
+}
+
+int32 FJsonTapeDocument::FindStringSpecial(int32 Cursor) const {
+    return bSimdScan ? JsonSimdScan::FindStringSpecial(Source.GetData(), Cursor, Source.Num()) : JsonSimdScan::FindStringSpecialScalar(Source.GetData(), Cursor, Source.Num());
+}
+
+bool FJsonTapeDocument::Parse() {
+    enum class EExpect : uint8 {
+        Value,
+        ValueOrArrayEnd,
+        Key,
+        KeyOrObjectEnd,
+        Colon,
+        CommaOrEnd,
+        Done
+    };
+
+    if (IsCompressed(Source)) {
+        return Decompress();
+    }
+    if (IsCooked(Source)) {
+        return ReadCooked();
+    }
+
+    const int32 Length = Source.Num();
+    Tape.Reset();
+    bSimdScan = JsonSimdScan::bAvailable and CVarJsonSimdScan.GetValueOnAnyThread();
+
+    // Typical documents need about one word per eight bytes
+    Tape.Reserve(Length / 8 + 4);
+
+    int32 Cursor = 0;
+    if (Length >= 3 and Source[0] == 0xEF and Source[1] == 0xBB and Source[2] == 0xBF) {
+        Cursor = 3;
+    }
+
+    // Tape index and child count of every open container
+    TArray<TPair<int32, uint32>, TInlineAllocator<64>> Open;
+    EExpect Expect = EExpect::Value;
+
+    for (Cursor = SkipWhitespace(Cursor); Cursor < Length; Cursor = SkipWhitespace(Cursor)) {
+        const uint8 Byte = Source[Cursor];
+        bool bValue = false;
+        bool bClose = false;
+
+        switch (Expect) {
+        case EExpect::Done:
+            return Fail(TEXT("Unexpected data after the root value"), Cursor);
+
+        case EExpect::ValueOrArrayEnd:
+            bClose = Byte == ']';
+            bValue = !bClose;
+            break;
+
+        case EExpect::Value:
+            bValue = true;
+            break;
+
+        case EExpect::KeyOrObjectEnd:
+            if (Byte == '}') {
+                bClose = true;
+                break;
+            }
+            [[fallthrough]];
+        case EExpect::Key:
+            if (Byte != '"') {
+                return Fail(TEXT("Expected a key"), Cursor);
+            }
+            if (!ParseString(Cursor)) {
+                return false;
+            }
+            Open.Last().Value++;
+            Expect = EExpect::Colon;
+            break;
+
+        case EExpect::Colon:
+            if (Byte != ':') {
+                return Fail(TEXT("Expected ':' after a key"), Cursor);
+            }
+            Cursor++;
+            Expect = EExpect::Value;
+            break;
+
+        case EExpect::CommaOrEnd:
+            if (Byte == ',') {
+                Cursor++;
+                Expect = TypeOf(Tape[Open.Last().Key]) == EJsonTapeType::ObjectStart ? EExpect::Key : EExpect::Value;
+            }
+            else if (Byte == '}' or Byte == ']') {
+                bClose = true;
+            }
+            else {
+                return Fail(TEXT("Expected ',' or the end of a container"), Cursor);
+            }
+            break;
+        }
+
+        if (bClose) {
+            const bool bObject = Byte == '}';
+            if (Open.Num() == 0 or TypeOf(Tape[Open.Last().Key]) != (bObject ? EJsonTapeType::ObjectStart : EJsonTapeType::ArrayStart)) {
+                return Fail(TEXT("Mismatched end of container"), Cursor);
+            }
+
+            const TPair<int32, uint32> Start = Open.Pop(false);
+            Tape.Add(MakeWord(bObject ? EJsonTapeType::ObjectEnd : EJsonTapeType::ArrayEnd, Start.Key));
+            const uint64 Count = FMath::Min(Start.Value, MaxChildCount);
+            Tape[Start.Key] = MakeWord(bObject ? EJsonTapeType::ObjectStart : EJsonTapeType::ArrayStart, (Count << 32) | static_cast<uint32>(Tape.Num()));
+            Cursor++;
+            Expect = Open.Num() == 0 ? EExpect::Done : EExpect::CommaOrEnd;
+            continue;
+        }
+        if (!bValue) {
+            continue;
+        }
+
+        // Array elements are counted here, object fields by their key
+        if (Open.Num() > 0 and TypeOf(Tape[Open.Last().Key]) == EJsonTapeType::ArrayStart) {
+            Open.Last().Value++;
+        }
+
+        switch (Byte) {
+        case '{':
+        case '[':
+            if (Open.Num() >= MaxDepth) {
+                return Fail(TEXT("Nesting is too deep"), Cursor);
+            }
+            Open.Emplace(Tape.Num(), 0);
+            Tape.Add(MakeWord(Byte == '{' ? EJsonTapeType::ObjectStart : EJsonTapeType::ArrayStart));
+            Cursor++;
+            Expect = Byte == '{' ? EExpect::KeyOrObjectEnd : EExpect::ValueOrArrayEnd;
+            continue;
+
+        case '"':
+            if (!ParseString(Cursor)) {
+                return false;
+            }
+            break;
+
+        case 't':
+            if (!ParseLiteral(Cursor, "true", EJsonTapeType::True)) {
+                return false;
+            }
+            break;
+
+        case 'f':
+            if (!ParseLiteral(Cursor, "false", EJsonTapeType::False)) {
+                return false;
+            }
+            break;
+
+        case 'n':
+            if (!ParseLiteral(Cursor, "null", EJsonTapeType::Null)) {
+                return false;
+            }
+            break;
+
+        default:
+            if (!ParseNumber(Cursor)) {
+                return false;
+            }
+            break;
+        }
+        Expect = Open.Num() == 0 ? EExpect::Done : EExpect::CommaOrEnd;
+    }
+
+    if (Expect != EExpect::Done) {
+        return Fail(TEXT("Unexpected end of input"), Length);
+    }
+    Words = Tape;
+    return true;
+}
+
+bool FJsonTapeDocument::ParseString(int32& Cursor) {
+    const int32 Length = Source.Num();
+    const int32 Start = Cursor + 1;
+    bool bEscaped = false;
+
+    int32 At = Start;
+    for (;; At++) {
+        // Jump over the plain run, what stops the scan is a quote, a backslash or a control character
+        At = FindStringSpecial(At);
+        if (At >= Length) {
+            return Fail(TEXT("Unterminated string"), Start - 1);
+        }
+
+        const uint8 Byte = Source[At];
+        if (Byte == '"') {
+            break;
+        }
+        if (Byte < 0x20) {
+            return Fail(TEXT("Control character in string"), At);
+        }
+
+        bEscaped = true;
+        if (++At >= Length) {
+            return Fail(TEXT("Unterminated escape sequence"), At);
+        }
+        switch (Source[At]) {
+        case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+            break;
+        case 'u':
+            for (int32 Digit = 1; Digit <= 4; Digit++) {
+                if (At + Digit >= Length or !FChar::IsHexDigit(static_cast<TCHAR>(Source[At + Digit]))) {
+                    return Fail(TEXT("Invalid \\u escape"), At);
+                }
+            }
+            At += 4;
+            break;
+        default:
+            return Fail(TEXT("Invalid escape sequence"), At);
+        }
+    }
+
+    Tape.Add(MakeWord(EJsonTapeType::String, Start));
+    Tape.Add(static_cast<uint64>(At - Start) | (bEscaped ? EscapedBit : 0));
+    Cursor = At + 1;
+    return true;
+}
+
+bool FJsonTapeDocument::ParseNumber(int32& Cursor) {
+    const int32 Length = Source.Num();
+    const int32 Start = Cursor;
+    int32 At = Cursor;
+
+    auto SkipDigits = [this, &At, Length]() {
+        const int32 First = At;
+        while (At < Length and Source[At] >= '0' and Source[At] <= '9') {
+            At++;
+        }
+        return At - First;
+        };
+
+    // -?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?
+    if (At < Length and Source[At] == '-') {
+        At++;
+    }
+    if (At < Length and Source[At] == '0') {
+        At++;
+    }
+    else if (SkipDigits() == 0) {
+        return Fail(TEXT("Invalid value"), Start);
+    }
+    if (At < Length and Source[At] == '.') {
+        At++;
+        if (SkipDigits() == 0) {
+            return Fail(TEXT("Invalid number"), Start);
+        }
+    }
+    if (At < Length and (Source[At] == 'e' or Source[At] == 'E')) {
+        At++;
+        if (At < Length and (Source[At] == '+' or Source[At] == '-')) {
+            At++;
+        }
+        if (SkipDigits() == 0) {
+            return Fail(TEXT("Invalid number"), Start);
+        }
+    }
+
+    // Atod wants a terminated string and the source is not
+    ANSICHAR Text[128];
+    const int32 TextLength = At - Start;
+    if (TextLength >= UE_ARRAY_COUNT(Text)) {
+        return Fail(TEXT("Number is too long"), Start);
+    }
+    FMemory::Memcpy(Text, Source.GetData() + Start, TextLength);
+    Text[TextLength] = '\0';
+
+    const double Value = FCStringAnsi::Atod(Text);
+    uint64 Bits = 0;
+    FMemory::Memcpy(&Bits, &Value, sizeof(double));
+
+    Tape.Add(MakeWord(EJsonTapeType::Number));
+    Tape.Add(Bits);
+    Cursor = At;
+    return true;
+}
+
+bool FJsonTapeDocument::ParseLiteral(int32& Cursor, const char* Text, EJsonTapeType Type) {
+    const int32 TextLength = FCStringAnsi::Strlen(Text);
+    if (Cursor + TextLength > Source.Num() or FMemory::Memcmp(Source.GetData() + Cursor, Text, TextLength) != 0) {
+        return Fail(TEXT("Invalid literal"), Cursor);
+    }
+    Tape.Add(MakeWord(Type));
+    Cursor += TextLength;
+    return true;
+}
+
+bool FJsonTapeDocument::IsCooked(TArrayView<const uint8> Bytes) {
+    // No JSON text can start with the magic, so the check is unambiguous
+    uint32 Magic = 0;
+    if (Bytes.Num() >= sizeof(FJsonCookedHeader)) {
+        FMemory::Memcpy(&Magic, Bytes.GetData(), sizeof(Magic));
+    }
+    return Magic == CookedMagic;
+}
+
+bool FJsonTapeDocument::IsCompressed(TArrayView<const uint8> Bytes) {
+    uint32 Magic = 0;
+    if (Bytes.Num() >= sizeof(FJsonCompressedHeader)) {
+        FMemory::Memcpy(&Magic, Bytes.GetData(), sizeof(Magic));
+    }
+    return Magic == CompressedMagic;
+}
+
+bool FJsonTapeDocument::WriteCompressed(TArrayView<const uint8> Bytes, TArray<uint8>& OutBytes) {
+    FJsonCompressedHeader Header;
+    Header.Magic = CompressedMagic;
+    Header.Version = CompressedVersion;
+    Header.UncompressedSize = Bytes.Num();
+
+    int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Bytes.Num());
+    OutBytes.SetNumUninitialized(sizeof(Header) + CompressedSize);
+    FMemory::Memcpy(OutBytes.GetData(), &Header, sizeof(Header));
+    if (!FCompression::CompressMemory(NAME_Zlib, OutBytes.GetData() + sizeof(Header), CompressedSize, Bytes.GetData(), Bytes.Num())) {
+        OutBytes.Reset();
+        return false;
+    }
+    OutBytes.SetNum(sizeof(Header) + CompressedSize, false);
+    return true;
+}
+
+bool FJsonTapeDocument::Uncompress(TArrayView<const uint8> Bytes, TArray<uint8>& OutBytes) {
+    OutBytes.Reset();
+    if (!IsCompressed(Bytes)) {
+        return false;
+    }
+
+    FJsonCompressedHeader Header;
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+    if (Header.Version != CompressedVersion or Header.UncompressedSize > MAX_int32) {
+        return false;
+    }
+
+    OutBytes.SetNumUninitialized(static_cast<int32>(Header.UncompressedSize));
+    const int32 CompressedSize = Bytes.Num() - static_cast<int32>(sizeof(Header));
+    if (!FCompression::UncompressMemory(NAME_Zlib, OutBytes.GetData(), OutBytes.Num(), Bytes.GetData() + sizeof(Header), CompressedSize)) {
+        OutBytes.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FJsonTapeDocument::Decompress() {
+    TArray<uint8> Bytes;
+    if (!Uncompress(Source, Bytes)) {
+        return Fail(TEXT("Corrupt or unsupported compressed JSON"), 0);
+    }
+
+    // The packed bytes are not needed once unpacked, drop the mapping and parse the owned copy
+    MappedRegion.Reset();
+    MappedFile.Reset();
+    OwnedBytes = MoveTemp(Bytes);
+    Source = OwnedBytes;
+    if (IsCompressed(Source)) {
+        return Fail(TEXT("Nested compressed JSON"), 0);
+    }
+    return Parse();
+}
+
+bool FJsonTapeDocument::WriteCooked(TArray<uint8>& OutBytes, int64 SourceSize, const FDateTime& SourceTimestamp) const {
+    if (Words.Num() == 0) {
+        return false;
+    }
+
+    TArray<uint64> CookedWords(Words.GetData(), Words.Num());
+    TArray<uint8> Strings;
+    Strings.Reserve(Source.Num());
+
+    // Offset and length of every key already written, by CRC of its bytes
+    TMultiMap<uint32, TPair<uint32, uint32>> InternedKeys;
+    uint32 KeyCount = 0;
+
+    // Open containers, true for objects, and whether the next string inside an object is a key
+    TArray<bool, TInlineAllocator<64>> Open;
+    TArray<bool, TInlineAllocator<64>> ExpectKey;
+
+    for (int32 At = 0; At < Words.Num();) {
+        const EJsonTapeType Type = GetWordType(At);
+        if (Type == EJsonTapeType::ObjectEnd or Type == EJsonTapeType::ArrayEnd) {
+            Open.Pop(false);
+            ExpectKey.Pop(false);
+            At++;
+            continue;
+        }
+
+        bool bKey = false;
+        if (Open.Num() > 0 and Open.Last()) {
+            bKey = ExpectKey.Last();
+            ExpectKey.Last() = !bKey;
+        }
+
+        if (Type == EJsonTapeType::ObjectStart or Type == EJsonTapeType::ArrayStart) {
+            Open.Add(Type == EJsonTapeType::ObjectStart);
+            ExpectKey.Add(true);
+            At++;
+            continue;
+        }
+        if (Type != EJsonTapeType::String) {
+            At += Type == EJsonTapeType::Number ? 2 : 1;
+            continue;
+        }
+
+        const uint8* Bytes = Source.GetData() + GetWordPayload(At);
+        const uint32 Length = static_cast<uint32>(Words[At + 1] & ~EscapedBit);
+
+        int32 Offset = INDEX_NONE;
+        const uint32 Crc = FCrc::MemCrc32(Bytes, Length);
+        if (bKey) {
+            TArray<TPair<uint32, uint32>, TInlineAllocator<4>> Candidates;
+            InternedKeys.MultiFind(Crc, Candidates);
+            for (const TPair<uint32, uint32>& Candidate : Candidates) {
+                if (Candidate.Value == Length and FMemory::Memcmp(Strings.GetData() + Candidate.Key, Bytes, Length) == 0) {
+                    Offset = static_cast<int32>(Candidate.Key);
+                    break;
+                }
+            }
+        }
+        if (Offset == INDEX_NONE) {
+            Offset = Strings.Num();
+            Strings.Append(Bytes, Length);
+            if (bKey) {
+                InternedKeys.Add(Crc, TPair<uint32, uint32>(Offset, Length));
+                KeyCount++;
+            }
+        }
+
+        CookedWords[At] = MakeWord(EJsonTapeType::String, Offset);
+        At += 2;
+    }
+
+    FJsonCookedHeader Header;
+    Header.Magic = CookedMagic;
+    Header.Version = CookedVersion;
+    Header.KeyCount = KeyCount;
+    Header.Reserved = 0;
+    Header.WordCount = CookedWords.Num();
+    Header.StringBytes = Strings.Num();
+    Header.SourceSize = SourceSize;
+    Header.SourceTicks = SourceTimestamp.GetTicks();
+
+    OutBytes.Reset(static_cast<int32>(sizeof(Header) + CookedWords.Num() * sizeof(uint64) + Strings.Num()));
+    OutBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    OutBytes.Append(reinterpret_cast<const uint8*>(CookedWords.GetData()), CookedWords.Num() * sizeof(uint64));
+    OutBytes.Append(Strings);
+    return true;
+}
+
+bool FJsonTapeDocument::ReadCooked() {
+    FJsonCookedHeader Header;
+    FMemory::Memcpy(&Header, Source.GetData(), sizeof(Header));
+
+    const uint64 WordBytes = Header.WordCount * sizeof(uint64);
+    if (Header.Version != CookedVersion or Header.WordCount == 0 or sizeof(Header) + WordBytes + Header.StringBytes != static_cast<uint64>(Source.Num())) {
+        return Fail(TEXT("Cooked document has another version or a broken header"), 0);
+    }
+
+    const int32 WordCount = static_cast<int32>(Header.WordCount);
+    const uint8* WordData = Source.GetData() + sizeof(Header);
+    const TArrayView<const uint8> Strings = Source.Slice(static_cast<int32>(sizeof(Header) + WordBytes), static_cast<int32>(Header.StringBytes));
+
+    // Mapped files and heap buffers are aligned, a copy is only a fallback
+    if (IsAligned(WordData, alignof(uint64))) {
+        Words = TConstArrayView<uint64>(reinterpret_cast<const uint64*>(WordData), WordCount);
+    }
+    else {
+        Tape.SetNumUninitialized(WordCount);
+        FMemory::Memcpy(Tape.GetData(), WordData, WordBytes);
+        Words = Tape;
+    }
+    Source = Strings;
+
+    // Navigation trusts the words, so every link, string range and the nesting are checked once here, the way the parser built them
+    struct FOpenContainer {
+        int32 Start;
+        int32 End;
+        uint32 Children;
+        bool bObject;
+        bool bExpectKey;
+    };
+    TArray<FOpenContainer, TInlineAllocator<64>> Open;
+
+    for (int32 At = 0; At < WordCount;) {
+        const EJsonTapeType Type = GetWordType(At);
+        if (At > 0 and Open.Num() == 0) {
+            return Fail(TEXT("Cooked document has data after the root value"), At);
+        }
+
+        if (Type == EJsonTapeType::ObjectEnd or Type == EJsonTapeType::ArrayEnd) {
+            const FOpenContainer* Container = Open.Num() > 0 ? &Open.Last() : nullptr;
+            if (!Container or At != Container->End or Type != (Container->bObject ? EJsonTapeType::ObjectEnd : EJsonTapeType::ArrayEnd)
+                or GetWordPayload(At) != static_cast<uint64>(Container->Start) or !Container->bExpectKey
+                or (GetWordPayload(Container->Start) >> 32) != FMath::Min(Container->Children, MaxChildCount)) {
+                return Fail(TEXT("Cooked document has a mismatched end of container"), At);
+            }
+            Open.Pop(false);
+            At++;
+            continue;
+        }
+
+        // Values of a container stop one word before its end, which has to be there
+        const int32 Limit = Open.Num() > 0 ? Open.Last().End : WordCount;
+        if (At == Limit) {
+            return Fail(TEXT("Cooked document is missing the end of a container"), At);
+        }
+
+        // Object children alternate between a string key and its value, fields are counted by their key
+        if (Open.Num() > 0) {
+            FOpenContainer& Parent = Open.Last();
+            if (!Parent.bObject or Parent.bExpectKey) {
+                if (Parent.bObject and Type != EJsonTapeType::String) {
+                    return Fail(TEXT("Cooked document has a key that is not a string"), At);
+                }
+                Parent.Children++;
+            }
+            if (Parent.bObject) {
+                Parent.bExpectKey = !Parent.bExpectKey;
+            }
+        }
+
+        switch (Type) {
+        case EJsonTapeType::String:
+            if (At + 2 > Limit or GetWordPayload(At) + (Words[At + 1] & ~EscapedBit) > static_cast<uint64>(Source.Num())) {
+                return Fail(TEXT("Cooked document has a string outside its string bytes"), At);
+            }
+            At += 2;
+            break;
+        case EJsonTapeType::Number:
+            if (At + 2 > Limit) {
+                return Fail(TEXT("Cooked document ends inside a number"), At);
+            }
+            At += 2;
+            break;
+        case EJsonTapeType::ObjectStart:
+        case EJsonTapeType::ArrayStart: {
+            const int32 Next = static_cast<int32>(GetWordPayload(At) & MAX_uint32);
+            if (Next <= At + 1 or Next > Limit or Open.Num() >= MaxDepth) {
+                return Fail(TEXT("Cooked document has a broken container"), At);
+            }
+            Open.Add({ At, Next - 1, 0, Type == EJsonTapeType::ObjectStart, true });
+            At++;
+            break;
+        }
+        case EJsonTapeType::Null:
+        case EJsonTapeType::True:
+        case EJsonTapeType::False:
+            At++;
+            break;
+        default:
+            return Fail(TEXT("Cooked document has an unknown word"), At);
+        }
+    }
+    if (Open.Num() > 0) {
+        return Fail(TEXT("Cooked document ends inside a container"), WordCount);
+    }
+
+    CookedSourceSize = Header.SourceSize;
+    CookedSourceTicks = Header.SourceTicks;
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UBoxComponent;
+
+// Collision stand-ins of the server build profile. Walls and floors become box components
+// on the owning room or corridor, entrances become bare actors holding a trigger volume.
+// Nothing here loads a visual class.
+namespace DungeonCollision {
+	constexpr float WallThickness = 40.f;
+	constexpr float FloorThickness = 20.f;
+
+	// Box centered on the wall pivot, standing on it and spanning WallHeight
+	GAMEDEMO_API UBoxComponent* AddWallBox(AActor* Owner, const FVector& WallLocation, const FRotator& WallRotation, float WallLength, float WallHeight);
+
+	// Box under the whole floor, placed like the visual floor piece
+	GAMEDEMO_API UBoxComponent* AddFloorBox(AActor* Owner, const FVector& StartLocation, const FRotator& StartRotation, int32 ForwardWalls, int32 RightWalls, float WallLength);
+
+	// Doorway actor located at the entrance pivot, so the dungeon can use it like a visual entrance
+	GAMEDEMO_API AActor* SpawnEntranceVolume(UWorld* World, const FVector& Location, const FRotator& Rotation, float WallLength, float WallHeight);
+
+	GAMEDEMO_API void DestroyBoxes(TArray<UBoxComponent*>& Boxes);
+
+	// Spawn a visual piece. Without collision the actor is switched off before its components register,
+	// so it never creates physics state or overlaps until collision is enabled again
+	GAMEDEMO_API AActor* SpawnPiece(UWorld* World, UClass* Class, const FTransform& Transform, bool bEnableCollision);
+}
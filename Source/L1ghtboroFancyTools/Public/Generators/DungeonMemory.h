@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Generators/DungeonCoreMemory.h"
+
+class AActor;
+
+// Low level memory tracker tags of the generators, shown by "stat LLM" and memreport when LLM is enabled
+LLM_DECLARE_TAG_API(DungeonPieces, GAMEDEMO_API); // Spawned piece actors, their components and piece tables
+LLM_DECLARE_TAG_API(DungeonAssets, GAMEDEMO_API); // Asset lists and loaded piece classes
+LLM_DECLARE_TAG_API(DungeonConfig, GAMEDEMO_API); // Parsed JSON configuration
+
+// Memory of a room, a corridor or a whole dungeon, reported by Dungeon.MemReport
+struct FDungeonMemoryStats {
+	int32 Pieces = 0;
+	int32 Components = 0;
+
+	// Actors and components, by the size of their classes
+	SIZE_T ObjectBytes = 0;
+
+	// Heap owned by piece tables, object lists and asset data
+	SIZE_T ContainerBytes = 0;
+
+	SIZE_T GetTotalBytes() const { return ObjectBytes + ContainerBytes; }
+
+	FDungeonMemoryStats& operator+=(const FDungeonMemoryStats& Other) {
+		Pieces += Other.Pieces;
+		Components += Other.Components;
+		ObjectBytes += Other.ObjectBytes;
+		ContainerBytes += Other.ContainerBytes;
+		return *this;
+	}
+};
+
+namespace DungeonMemory {
+	// Add an actor and its components to the object bytes
+	GAMEDEMO_API void AccumulateActor(const AActor* Actor, FDungeonMemoryStats& Stats);
+
+	GAMEDEMO_API FString FormatBytes(SIZE_T Bytes);
+}
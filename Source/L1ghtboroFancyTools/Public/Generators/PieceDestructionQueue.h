@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogPieceDestruction, Log, All)
+
+// Per-dungeon queue of generated pieces waiting to be destroyed.
+// Pieces are hidden the moment they are queued and destroyed later in small batches,
+// so clearing a whole ring of rooms never lands in a single frame.
+class GAMEDEMO_API FPieceDestructionQueue {
+public:
+	// Hide the actor, switch off its collision and tick, and queue it for destruction
+	void Enqueue(AActor* Actor);
+
+	// Destroy queued actors until the time or piece budget is spent, returns how many were destroyed
+	int32 ProcessBatch(float BudgetSeconds, int32 MaxPieces);
+
+	// Destroy everything still queued right away
+	void Flush();
+
+	int32 Num() const { return PendingActors.Num() - Head; }
+
+	bool IsEmpty() const { return Num() == 0; }
+
+private:
+	void Compact();
+
+	TArray<TWeakObjectPtr<AActor>> PendingActors;
+
+	// Index of the next actor to destroy, the queue is compacted lazily
+	int32 Head = 0;
+};
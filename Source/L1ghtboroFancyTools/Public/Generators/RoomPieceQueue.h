@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Generators/DungeonPieceTypes.h"
+
+class AActor;
+
+// Piece published by a generation stage. Either already spawned (Actor is set)
+// or only planned (Class and Transform are set, the actor is spawned on commit).
+struct FRoomPieceRecord {
+	AActor* Actor = nullptr;
+	UClass* Class = nullptr;
+	FTransform Transform;
+	ERoomPieceCategory Category = ERoomPieceCategory::Wall;
+	ERoomPieceFlags ExtraFlags = ERoomPieceFlags::None;
+};
+
+// Multi-producer single-consumer inbox of room pieces.
+// Any thread may publish without locking, only the game thread drains it at a commit point.
+class FRoomPieceQueue {
+public:
+	// Publish an already spawned piece
+	void Publish(AActor* Actor, ERoomPieceCategory Category, ERoomPieceFlags ExtraFlags = ERoomPieceFlags::None) {
+		FRoomPieceRecord Record;
+		Record.Actor = Actor;
+		Record.Category = Category;
+		Record.ExtraFlags = ExtraFlags;
+		Pending.Enqueue(MoveTemp(Record));
+	}
+
+	// Publish a piece that still has to be spawned on the game thread
+	void PublishPlanned(UClass* Class, const FTransform& Transform, ERoomPieceCategory Category, ERoomPieceFlags ExtraFlags = ERoomPieceFlags::None) {
+		FRoomPieceRecord Record;
+		Record.Class = Class;
+		Record.Transform = Transform;
+		Record.Category = Category;
+		Record.ExtraFlags = ExtraFlags;
+		Pending.Enqueue(MoveTemp(Record));
+	}
+
+	// Hand every pending record to Func, returns how many were drained
+	template <typename FunctorType>
+	int32 Drain(FunctorType&& Func) {
+		check(IsInGameThread());
+
+		int32 Drained = 0;
+		FRoomPieceRecord Record;
+		while (Pending.Dequeue(Record)) {
+			Func(Record);
+			Drained++;
+		}
+		return Drained;
+	}
+
+	bool IsEmpty() const { return Pending.IsEmpty(); }
+
+private:
+	TQueue<FRoomPieceRecord, EQueueMode::Mpsc> Pending;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoomPieceQueue.h"
+
+class AActor;
+class FPieceDestructionQueue;
+class FReferenceCollector;
+
+// What a piece handle points at
+enum class ERoomPieceHandleKind : uint8 {
+	Actor,
+	Instance,
+	PoolSlot
+};
+
+// Reference to the runtime representation of a piece
+struct FRoomPieceHandle {
+	AActor* Actor = nullptr;
+	int32 Slot = INDEX_NONE;
+	ERoomPieceHandleKind Kind = ERoomPieceHandleKind::Actor;
+};
+
+// Structure-of-arrays storage of every piece of a room or corridor.
+// Bulk passes (hide, destroy, bounds, counting) walk the contiguous arrays
+// and only dereference actors when their state actually has to change.
+class GAMEDEMO_API FRoomPieceTable {
+public:
+	// Register a spawned actor, returns the piece index
+	int32 AddActor(AActor* Actor, UClass* Class, const FTransform& Transform, ERoomPieceCategory Category, ERoomPieceFlags ExtraFlags = ERoomPieceFlags::None);
+
+	// Register a piece backed by an instance or a pool slot
+	int32 AddSlot(int32 Slot, ERoomPieceHandleKind Kind, UClass* Class, const FTransform& Transform, ERoomPieceCategory Category, ERoomPieceFlags ExtraFlags = ERoomPieceFlags::None);
+
+	// Number of pieces matching any of the category bits
+	int32 Count(ERoomPieceFlags CategoryMask = ERoomPieceFlags::AllCategories) const;
+
+	// Box enclosing the pieces' origins, expanded by PieceExtent
+	FBox ComputeBounds(ERoomPieceFlags CategoryMask = ERoomPieceFlags::AllCategories, const FVector& PieceExtent = FVector::ZeroVector) const;
+
+	// Hide or show matching pieces, returns how many actors were touched
+	int32 SetHidden(ERoomPieceFlags CategoryMask, bool bHidden);
+
+	// Switch actor collision of the pieces from Cursor on, stops once MaxPieces actors were changed.
+	// Cursor is advanced past every visited piece, the number of changed actors is returned
+	int32 SetCollisionEnabled(bool bEnabled, int32& Cursor, int32 MaxPieces);
+
+	// Remove matching pieces and hand their actors to the queue, or destroy them in place without one
+	int32 DestroyPieces(ERoomPieceFlags CategoryMask, FPieceDestructionQueue* Queue);
+
+	// Same as DestroyPieces with an arbitrary predicate on the piece index, removed actors are optionally reported
+	int32 DestroyPiecesWhere(TFunctionRef<bool(int32 PieceIndex)> Predicate, FPieceDestructionQueue* Queue, TArray<AActor*>* OutRemovedActors = nullptr);
+
+	// Move a piece and replace its state flags, category and hidden bits are kept. Returns true when the transform changed
+	bool MovePiece(int32 PieceIndex, const FTransform& Transform, ERoomPieceFlags StateFlags);
+
+	void Reset();
+
+	// Report piece actors and classes to the collector, destroyed actors come back nulled
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	int32 Num() const { return Transforms.Num(); }
+
+	SIZE_T GetAllocatedSize() const;
+
+	const TArray<FTransform>& GetTransforms() const { return Transforms; }
+	const TArray<uint16>& GetClassIndices() const { return ClassIndices; }
+	const TArray<ERoomPieceFlags>& GetFlags() const { return Flags; }
+	const TArray<FRoomPieceHandle>& GetHandles() const { return Handles; }
+
+	UClass* GetClass(int32 PieceIndex) const { return ClassPalette[ClassIndices[PieceIndex]]; }
+
+private:
+	int32 Add(const FRoomPieceHandle& Handle, UClass* Class, const FTransform& Transform, ERoomPieceFlags PieceFlags);
+
+	uint16 GetClassIndex(UClass* Class);
+
+	TArray<FTransform> Transforms;
+	TArray<uint16> ClassIndices;
+	TArray<ERoomPieceFlags> Flags;
+	TArray<FRoomPieceHandle> Handles;
+
+	// Distinct classes used by the pieces, a room only ever uses a handful
+	TArray<UClass*> ClassPalette;
+};
@@ -4,10 +4,17 @@
 #include "GameFramework/Actor.h"
 #include "DataStructures/CorridorStruct.h"
 #include "DataStructures/RoomAssetStruct.h"
+#include "RoomPieceTable.h"
+#include "Generators/DungeonGrid.h"
 #include "SpawnCorridor.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSpawnCorridor, Log, All)
 
+class FPieceDestructionQueue;
+class ASpawnDungeon;
+struct FDungeonMemoryStats;
+class UBoxComponent;
+
 UCLASS() class GAMEDEMO_API ASpawnCorridor : public AActor {
 	GENERATED_BODY()
 	
@@ -38,16 +45,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Spawn Roof")
 	void DestroyCorridor();
 
-	virtual void Tick(float DeltaTime) override;
+	// Dungeon that owns this corridor, pieces are handed over to its queue instead of being destroyed in place
+	void SetOwningDungeon(ASpawnDungeon* Dungeon) { OwningDungeon = Dungeon; }
 
-private: 
-	UFUNCTION(BlueprintAuthorityOnly, Category = "Spawn Wall")
-	FVector CreateWallSegment(TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLighted, FVector StartLocation, FRotator StartRotation, int32 NumberOfWalls, float WallLength, float GapBetweenWalls);
+	// Build only collision, set before CreateCorridor. On by default on dedicated servers
+	UFUNCTION(BlueprintCallable, Category = "Spawn Corridor")
+	void SetCollisionOnly(bool bNewCollisionOnly) { bCollisionOnly = bNewCollisionOnly; }
+
+	UFUNCTION(BlueprintCallable, Category = "Spawn Corridor")
+	bool IsCollisionOnly() const { return bCollisionOnly; }
+
+	UFUNCTION(BlueprintCallable, Category = "Struct Corridor")
+	void SetCorridorHidden(bool bHidden);
+
+	UFUNCTION(BlueprintCallable, Category = "Struct Corridor")
+	int32 GetPieceCount() const { return PieceTable.Num(); }
+
+	const FRoomPieceTable& GetPieceTable() const { return PieceTable; }
+
+	// Add the memory of the corridor's pieces and bookkeeping, used by Dungeon.MemReport
+	void CollectMemoryStats(FDungeonMemoryStats& OutStats) const;
 
-	UFUNCTION(BlueprintAuthorityOnly, Category = "Spawn Wall")
-	FVector GenerateWalls(UWorld* World, TSubclassOf<AActor> WallClass, FVector StartLocation = FVector::ZeroVector, FRotator StartRotation = FRotator::ZeroRotator, int32 NumberOfWalls = -1, float WallLength = -1.f, float GapBetweenWalls = -1.f, TSubclassOf<AActor> WallClassLightned = nullptr);
+	virtual void Tick(float DeltaTime) override;
+
+	// Pieces live in the piece table, which the collector does not see on its own
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 
-	FVector DotProduct(FVector PositioningVector, FVector SymbolVector, float WallLength, float WallHeight);
+private: 
+	// Spawn the walls of one side, positions are lattice points resolved against the corridor origin
+	void GenerateWalls(UWorld* World, TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLighted, FVector Origin, FRotator OriginRotation, EDungeonOrientation Side, int32 NumberOfWallsForward, int32 NumberOfWallsRight, float GridUnit);
 
 	void AssignCorridorAssets(const FString& FilePath);
 
@@ -66,9 +92,33 @@ private:
 
 	FString CorridroTag;
 
+	// Weak, the corridor may outlive the dungeon and then destroys its pieces in place
+	TWeakObjectPtr<ASpawnDungeon> OwningDungeon;
+
+	FPieceDestructionQueue* GetDestructionQueue() const;
+
+	// Contiguous storage of every spawned piece, used by bulk passes
+	FRoomPieceTable PieceTable;
+
+	bool bCollisionOnly;
+
+	// Floor to roof of a single wall row corridor
+	static constexpr float CollisionShellHeight = 430.f;
+
+	// Collision boxes of the server profile, referenced by Instance pieces through their index
+	UPROPERTY()
+	TArray<UBoxComponent*> CollisionBoxes;
+
+	void AddCollisionPiece(UBoxComponent* Box, ERoomPieceCategory Category);
+
+	// Loaded at runtime, referenced here so they are not collected between corridors
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultFloorClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultWallClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultWallClassLightned;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultRoofClass;
 public:
 	//Getters
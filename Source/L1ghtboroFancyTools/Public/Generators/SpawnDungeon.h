@@ -4,22 +4,58 @@
 #include "GameFramework/Actor.h"
 #include "SpawnRoom.h"
 #include "SpawnCorridor.h"
+#include "PieceDestructionQueue.h"
+#include "Generators/DungeonGraph.h"
+#include "Generators/DungeonChunks.h"
 #include "SpawnDungeon.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSpawnDungeon, Log, All)
 
+// What rooms and corridors are built from
+UENUM(BlueprintType)
+enum class EDungeonBuildProfile : uint8 {
+	// Collision only on dedicated servers, visual everywhere else
+	Auto          UMETA(DisplayName = "Auto"),
+
+	// Every visual blueprint
+	Visual        UMETA(DisplayName = "Visual"),
+
+	// Collision boxes, doorway and player detection volumes, no visual class is loaded
+	CollisionOnly UMETA(DisplayName = "Collision Only")
+};
+
+// Camera of the visibility pass. Portals are clipped in tangent space, where a point maps to (right / depth, up / depth)
+// and the view is the rectangle of the tangents of the half field of view
+struct FDungeonPortalView {
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FVector Forward = FVector::ForwardVector;
+	FVector Right = FVector::RightVector;
+	FVector Up = FVector::UpVector;
+	FBox2D Rect = FBox2D(ForceInit);
+
+	// Tangent space rectangle covered by Box, false when it is entirely behind the camera.
+	// A box the camera plane cuts through, e.g. a doorway the player stands in, covers the whole view
+	bool ProjectBox(const FBox& Box, FBox2D& OutRect) const;
+};
+
 UCLASS() class GAMEDEMO_API ASpawnDungeon : public AActor {
 	GENERATED_BODY()
 	
 public:	
 	ASpawnDungeon();
 
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Dungeon Generation")
 	TArray<ASpawnRoom*> RoomDungeon;
+
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Dungeon Generation")
 	TArray<ASpawnCorridor*> CorridorDungeon;
 
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	virtual void Tick(float DeltaTime) override;
 
@@ -35,10 +71,110 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Dungeon Generation")
 	void GenerateDungeonEternal();
 
-	void ClearDungeon(ASpawnRoom* RoomToSkip);
+	void ClearDungeon(ASpawnRoom* RoomToSkip) { ClearDungeon(TArray<ASpawnRoom*>{ RoomToSkip }); }
+
+	// Destroy every room except the kept ones, and every corridor
+	void ClearDungeon(const TArray<ASpawnRoom*>& RoomsToKeep);
+
+	// Players this instance follows. While none are assigned every player of the world is followed
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Players")
+	void AssignPlayer(APlayerController* Player);
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Players")
+	void UnassignPlayer(APlayerController* Player);
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Players")
+	int32 GetAssignedPlayerCount() const { return AssignedPlayers.Num(); }
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Generation")
+	EDungeonBuildProfile BuildProfile;
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Generation")
+	bool IsCollisionOnly() const;
+
+	// Seed of the instance random stream, 0 picks a new one on BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Generation")
+	int32 Seed;
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Generation")
+	int32 GetSeed() const { return RandomStream.GetInitialSeed(); }
+
+	// Side of the square chunks the plane is addressed by, corridors and rooms are planned per chunk
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Chunks", meta = (ClampMin = "1000.0", Units = "cm"))
+	float ChunkSize;
+
+	// Keep planned chunk layouts in Saved/DungeonCache between sessions. Ignored while Seed is 0, a random seed never repeats
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Chunks")
+	bool bUseLayoutCache;
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Chunks")
+	FIntPoint GetChunkCoord(FVector Location) const { return ChunkCache.GetChunkCoord(Location); }
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Chunks")
+	bool SaveLayoutCache();
+
+	const FDungeonChunkCache& GetChunkCache() const { return ChunkCache; }
+
+	// Topology of rooms, corridors and entrances currently alive
+	const FDungeonGraph& GetDungeonGraph() const { return DungeonGraph; }
+
+	// Graph node of a room, corridor or entrance, INDEX_NONE when unknown
+	FDungeonNodeId GetNodeOfActor(const AActor* Actor) const;
+
+	// Number of graph edges between two rooms, -1 when unreachable
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Topology")
+	int32 GetRoomHopDistance(ASpawnRoom* From, ASpawnRoom* To) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Topology")
+	ASpawnRoom* FindNearestRoomWithTag(ASpawnRoom* From, const FString& Tag) const;
+
+	// Rooms, entrances and corridors on the shortest path, empty when unreachable
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Topology")
+	TArray<AActor*> FindPathBetween(AActor* From, AActor* To) const;
+
+	// Rooms within this many room steps of the player are built in full detail, the rest stay proxies
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Generation", meta = (ClampMin = "0"))
+	int32 FullDetailRoomRadius;
+
+	// Detail stages (upper walls, roof, lights) applied per frame across all rooms
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Generation", meta = (ClampMin = "1"))
+	int32 MaxDetailStepsPerFrame;
+
+	// Rooms within this many room steps of a player get collision and overlaps, the rest are spawned and kept without
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Physics", meta = (ClampMin = "0"))
+	int32 PhysicsRoomRadius;
+
+	// Rooms closer than this to a player are active as well, 0 relies on the room radius alone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Physics", meta = (ClampMin = "0.0", Units = "cm"))
+	float PhysicsActivationDistance;
+
+	// Upper bound of pieces whose collision is switched in a single frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Physics", meta = (ClampMin = "1"))
+	int32 MaxPhysicsPiecesPerFrame;
+
+	// Hide rooms and corridors that cannot be seen through entrances from the player's room
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Visibility")
+	bool bEnablePortalCulling;
+
+	// Number of pieces hidden and waiting to be destroyed
+	UFUNCTION(BlueprintCallable, Category = "Dungeon Generation")
+	int32 GetQueuedPieceCount() const { return DestructionQueue.Num(); }
+
+	FPieceDestructionQueue& GetDestructionQueue() { return DestructionQueue; }
+
+	// Memory and piece counts per room, per corridor and for the whole instance, printed by Dungeon.MemReport
+	void DumpMemoryReport(FOutputDevice& Ar) const;
+
+	// Time per frame the destruction queue is allowed to spend destroying pieces
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Generation", meta = (ClampMin = "0.0", Units = "ms"))
+	float DestructionBudgetMs;
+
+	// Upper bound of pieces destroyed in a single frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Generation", meta = (ClampMin = "1"))
+	int32 MaxPiecesDestroyedPerFrame;
 
 private:
-	void SetCorridorParameters(ASpawnCorridor* Corridor, AActor* Entrance);
+	void SetCorridorParameters(ASpawnCorridor* Corridor, AActor* Entrance, int32 CorridorWalls);
 	
 	FVector GetEntranceDirection(FRotator Rotation);
 
@@ -46,27 +182,103 @@ private:
 
 	FVector GetNewLocation(FVector EntranceLocation, FVector Direction, float OffsetDistance);
 
-	int32 GetRandomRangeValue(ASpawnRoom* Room, float OriginalYaw);
-
 	float GetNewYaw(float OriginalYaw);
 
 	FVector GetAdjustVector(ASpawnRoom* Room, FEntranceStruct NewEntrance);
 
-	APawn* GetPlayePawn() const;
+	// Spawn a room owned by this instance: ID and destruction queue come from the dungeon, seed and size from the plan
+	ASpawnRoom* SpawnDungeonRoom(UWorld* World, FVector Location, const FDungeonRoomPlan& Plan);
+
+	void GetTrackedPawns(TArray<APawn*>& OutPawns) const;
+
+	// Rooms holding at least one tracked player, without duplicates. OutViewerRoom receives the room of the local viewer
+	void GetOccupiedRooms(TArray<ASpawnRoom*>& OutRooms, ASpawnRoom** OutViewerRoom = nullptr);
+
+	// Controller whose camera drives the visibility pass, null on dedicated servers
+	APlayerController* GetLocalViewer() const;
 
 	ASpawnRoom* GetCurrentRoom(APawn* PlayerPawn);
 
-	void ClearCorridors();
+	void ClearCorridors(const TArray<ASpawnCorridor*>& CorridorsToKeep);
+
+	bool LinksKeptRooms(FDungeonNodeId CorridorNode, const TSet<FDungeonNodeId>& KeptRoomNodes) const;
+
+	bool IsEntranceConnected(const AActor* Entrance) const;
+
+	FDungeonNodeId RegisterRoomNode(ASpawnRoom* Room);
+
+	void UnregisterNode(AActor* Actor);
+
+	void BindNodeActor(FDungeonNodeId Node, AActor* Actor);
+
+	AActor* FindClosestEntrance(ASpawnRoom* Room, FVector Location) const;
+
+	void UpdateDetailTargets(const TArray<ASpawnRoom*>& PlayerRooms);
+
+	void UpdatePhysicsTargets(const TArray<ASpawnRoom*>& PlayerRooms);
 
-	int32 CurrentRoomID;
+	// Room nodes within RoomSteps room steps of any of the player rooms
+	void GetRoomsWithinSteps(const TArray<ASpawnRoom*>& PlayerRooms, int32 RoomSteps, TSet<FDungeonNodeId>& OutRooms) const;
+
+	// Spend the per-frame budget on rooms gaining collision first, then on rooms losing it
+	void StepPhysicsActivation();
+
+	bool BuildPortalView(FDungeonPortalView& OutView) const;
+
+	void UpdatePortalVisibility();
+
+	// IDs of the occupied rooms the dungeon was last generated around, sorted
+	TArray<int32> OccupiedRoomIDs;
+
+	// Room IDs are unique per dungeon instance, not per process
+	int32 NextRoomID;
+
+	FRandomStream RandomStream;
+
+	FDungeonChunkCache ChunkCache;
+
+	TArray<TWeakObjectPtr<APlayerController>> AssignedPlayers;
 
 	int32 RoomSpawned;
 
 	FTimerHandle DungeonCheckTimerHandle;
 
+	FPieceDestructionQueue DestructionQueue;
+
+	// Set when a clear queued pieces, with Dungeon.CollectAfterEviction a collection is requested once the queue has drained
+	bool bCollectWhenQueueDrained;
+
+	FDungeonGraph DungeonGraph;
+
+	// Mapping between graph nodes and the actors they stand for
+	TMap<const AActor*, FDungeonNodeId> ActorNodes;
+	TMap<FDungeonNodeId, TWeakObjectPtr<AActor>> NodeActors;
+
+	// World bounds of every entrance node, the portals between cells
+	TMap<FDungeonNodeId, FBox> PortalBounds;
+
+	// Room of the local viewer as of the last occupancy check, the visibility pass starts there
+	TWeakObjectPtr<ASpawnRoom> ViewerRoom;
+
+	// View and layout the last visibility pass ran with, the pass is skipped while neither changes
+	FDungeonNodeId LastViewNode;
+	FDungeonPortalView LastView;
+	bool bPortalVisibilityDirty;
+
+	// Scratch state of the visibility pass, kept around to avoid per-frame allocations.
+	// Every reached node keeps the part of the view that is still open through the portals on the way to it
+	TMap<FDungeonNodeId, FBox2D> NodeViewRects;
+	TArray<FDungeonNodeId> PortalFrontier;
+	TArray<FDungeonNodeId> PortalNeighbours;
+
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultFloorClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultWallClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultWallClassLightned;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultEntranceClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultRoofClass;
 };
\ No newline at end of file
@@ -6,10 +6,29 @@
 #include "DataStructures/EntranceStruct.h"
 #include "DataStructures/RoomStruct.h"
 #include "DataStructures/RoomAssetStruct.h"
+#include "RoomPieceQueue.h"
+#include "RoomPieceTable.h"
+#include "Generators/DungeonGrid.h"
 #include "SpawnRoom.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSpawnRoom, Log, All)
 
+// How much of a room is built
+UENUM(BlueprintType)
+enum class ERoomDetailLevel : uint8 {
+	// Floor and outer shell with entrances, no lights, upper walls or roof
+	Proxy UMETA(DisplayName = "Proxy"),
+
+	// Everything
+	Full  UMETA(DisplayName = "Full")
+};
+
+class FPieceDestructionQueue;
+class ASpawnDungeon;
+struct FRoomShapeTemplate;
+struct FRoomShapeEntrances;
+struct FDungeonMemoryStats;
+
 UCLASS() class GAMEDEMO_API ASpawnRoom : public AActor {
 	GENERATED_BODY()
 	
@@ -25,6 +44,12 @@ public:
 
 	virtual void Tick(float DeltaTime) override;
 
+	// Pieces live in the piece table, which the collector does not see on its own
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	// Settled rooms become GC cluster roots when Dungeon.GCClusters is set
+	virtual bool CanBeClusterRoot() const override;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Struct Room")
 	FRoomStruct RoomObjects;
 
@@ -46,6 +71,10 @@ protected:
 public:
 	UFUNCTION(BlueprintCallable, Category = "Spawn Room")
 	void CreateRoom(FEntranceStruct EntranceInfo = FEntranceStruct());
+
+	// Apply changed parameters to a built room, only pieces whose slot appears, moves or disappears are touched
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Spawn Room")
+	void RebuildRoom();
 	
 	UFUNCTION(BlueprintCallable, Category = "Player Detect Comp")
 	void CreatePlayerDetector();
@@ -62,15 +91,88 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Destroy Room")
 	void DestroyRoom();
 
+	// Commit point: drains pieces published by generation stages into RoomObjects, game thread only
+	UFUNCTION(BlueprintCallable, Category = "Spawn Room")
+	int32 CommitPendingPieces();
+
+	// Tier the room moves towards, one StepDetailLevel call at a time
+	UFUNCTION(BlueprintCallable, Category = "Room Detail")
+	void SetTargetDetailLevel(ERoomDetailLevel NewLevel) { TargetDetailLevel = NewLevel; }
+
+	UFUNCTION(BlueprintCallable, Category = "Room Detail")
+	ERoomDetailLevel GetDetailLevel() const { return DetailStage == FullDetailStage ? ERoomDetailLevel::Full : ERoomDetailLevel::Proxy; }
+
+	UFUNCTION(BlueprintCallable, Category = "Room Detail")
+	bool NeedsDetailStep() const { return !bCollisionOnly and DetailStage != (TargetDetailLevel == ERoomDetailLevel::Full ? FullDetailStage : 0); }
+
+	UFUNCTION(BlueprintCallable, Category = "Room Detail")
+	bool StepDetailLevel();
+
+	UFUNCTION(BlueprintCallable, Category = "Struct Room")
+	void SetRoomHidden(bool bHidden);
+
+	UFUNCTION(BlueprintCallable, Category = "Struct Room")
+	FBox GetRoomBounds() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Struct Room")
+	int32 GetPieceCount() const { return PieceTable.Num(); }
+
+	const FRoomPieceTable& GetPieceTable() const { return PieceTable; }
+
+	// Add the memory of the room's pieces and bookkeeping, used by Dungeon.MemReport
+	void CollectMemoryStats(FDungeonMemoryStats& OutStats) const;
+
+	// Dungeon that owns this room, pieces are handed over to its queue instead of being destroyed in place
+	void SetOwningDungeon(ASpawnDungeon* Dungeon) { OwningDungeon = Dungeon; }
+
+	// Collision and overlaps of the pieces and the player detector. Switched a few pieces per frame by StepPhysicsActivation,
+	// pieces spawned meanwhile already follow the new state. Collision only rooms always stay active
+	UFUNCTION(BlueprintCallable, Category = "Room Physics")
+	void SetPhysicsActive(bool bActive);
+
+	UFUNCTION(BlueprintCallable, Category = "Room Physics")
+	bool IsPhysicsActive() const { return bPhysicsActive; }
+
+	UFUNCTION(BlueprintCallable, Category = "Room Physics")
+	bool NeedsPhysicsStep() const { return PhysicsCursor != INDEX_NONE; }
+
+	bool IsPhysicsActivating() const { return NeedsPhysicsStep() and bTargetPhysicsActive; }
+
+	// Apply the pending state to at most MaxPieces more actors, returns how many were changed
+	UFUNCTION(BlueprintCallable, Category = "Room Physics")
+	int32 StepPhysicsActivation(int32 MaxPieces);
+
+	// Build only collision and gameplay volumes, set before CreateRoom. On by default on dedicated servers
+	UFUNCTION(BlueprintCallable, Category = "Spawn Room")
+	void SetCollisionOnly(bool bNewCollisionOnly) { bCollisionOnly = bNewCollisionOnly; }
+
+	UFUNCTION(BlueprintCallable, Category = "Spawn Room")
+	bool IsCollisionOnly() const { return bCollisionOnly; }
+
 private:	
-	UFUNCTION(BlueprintCallable, Category = "Spawn Wal")
-	FVector DotProduct(FVector PositioningVector, FVector SymbolVector, float WallLength, float WallHeight);
-	
-	UFUNCTION(BlueprintCallable, Category = "Spawn Wall")
-	FVector GenerateWalls(UWorld* World, TSubclassOf<AActor> WallClass, FVector StartLocation = FVector::ZeroVector, FRotator StartRotation = FRotator::ZeroRotator, int32 NumberOfWalls = -1, float WallLength = -1.f, float GapBetweenWalls = -1.f, FEntranceStruct EntranceObject = FEntranceStruct(), TSubclassOf<AActor> WallClassLightned = nullptr);
+	// Spawn every piece of a cached shape with the extra entrances cut in, positions are lattice points resolved against the room origin
+	void SpawnShape(UWorld* World, const FRoomShapeTemplate& Shape, const FRoomShapeEntrances& Entrances, TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLightned, const TSubclassOf<AActor> (&EntranceClasses)[4], FVector Origin, FRotator OriginRotation, float GridUnit);
 
-	UFUNCTION(BlueprintCallable, Category = "Spawn Wall")
-	FVector CreateWallSegment(TSubclassOf<AActor> WallClass, TSubclassOf<AActor> WallClassLightned, FEntranceStruct& EntranceObject, FVector StartLocation, FRotator StartRotation, int32 NumberOfWalls, float WallLength, float GapBetweenWalls);
+	int32 ResolveEntranceIndex(const FEntranceStruct& EntranceObject, EDungeonOrientation Side, int32 NumberOfWallsForward, int32 NumberOfWallsRight, FVector Origin, FRotator OriginRotation, float GridUnit) const;
+
+	// Floor and roof transform, scaled to cover the whole room
+	FTransform GetSlabTransform(FVector StartLocation, FRotator StartRotation, int32 Width, int32 Length, float WallLength, float Height) const;
+
+	// Parameters the committed pieces were built with, RebuildRoom diffs against them
+	void RememberBuiltParams();
+
+	int32 BuiltForwardWalls;
+
+	int32 BuiltRightWalls;
+
+	float BuiltWallLength;
+
+	FVector BuiltStartLocation;
+
+	FRotator BuiltStartRotation;
+
+	// Entrances recovered by a collision only rebuild, CreateWall keeps them instead of rolling new ones
+	const FRoomShapeEntrances* RebuildEntrances = nullptr;
 
 	void CreateInitialDeco(FVector StartLocation, float WallLength, int32 NumberOfWallsForward, int32 NumberOfWallsRight);
 
@@ -130,13 +232,67 @@ private:
 
 	void AssignRoomAssets(const FString& FilePath);
 
-	static int32 RoomCount;
+	// Assigned by the owning dungeon, INDEX_NONE for standalone rooms
 	int32 RoomID;
 	bool bIsPlayerInRoom;
 
 	FTimerHandle PlayerCheckTimerHandle;
 	AActor* PlayerActor;
 
+	// Weak, the room may outlive the dungeon and then destroys its pieces in place
+	TWeakObjectPtr<ASpawnDungeon> OwningDungeon;
+
+	FPieceDestructionQueue* GetDestructionQueue() const;
+
+	// Every random decision of the room is drawn from here, never from the global generator
+	FRandomStream RandomStream;
+
+	// Lock-free inbox written by generation stages on any thread
+	FRoomPieceQueue PendingPieces;
+
+	// Contiguous storage of every committed piece, used by bulk passes
+	FRoomPieceTable PieceTable;
+
+	// Stages between proxy (0) and full detail: upper walls, roof, lighted walls
+	static constexpr int32 FullDetailStage = 3;
+
+	UPROPERTY(VisibleAnywhere, Category = "Room Detail")
+	ERoomDetailLevel TargetDetailLevel;
+
+	int32 DetailStage;
+
+	// Flags attached to pieces published by the stage currently running
+	ERoomPieceFlags StageFlags;
+
+	void ApplyDetailStage(int32 Stage, bool bAdd);
+
+	void SwapLightSlots(UClass* NewClass);
+
+	void RemovePieces(TFunctionRef<bool(int32 PieceIndex)> Predicate);
+
+	// Pieces of a room at its target tier are collected as one unit, the cluster is dissolved before pieces change
+	void CreatePieceCluster();
+
+	void DissolvePieceCluster();
+
+	bool bCollisionOnly;
+
+	// State every piece has, and the state pieces are being switched to while PhysicsCursor is set
+	bool bPhysicsActive;
+	bool bTargetPhysicsActive;
+	int32 PhysicsCursor;
+
+	void SetDetectorActive(bool bActive);
+
+	// Floor to roof, collision walls cover both wall rows
+	static constexpr float CollisionShellHeight = 880.f;
+
+	// Collision boxes of the server profile, referenced by Instance pieces through their index
+	UPROPERTY()
+	TArray<UBoxComponent*> CollisionBoxes;
+
+	void AddCollisionPiece(UBoxComponent* Box, ERoomPieceCategory Category);
+
 	void CheckPlayerPosition();
 	bool IsPointInsideBox(const FVector &Point, const FVector &BoxCenter, const FVector &BoxExtent, float VerticalMargin);
 
@@ -167,10 +323,16 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Room Assets", meta = (AllowPrivateAccess = "true"))
 	TArray<FAssetStruct> RoomAssetData;
 
+	// Loaded at runtime, referenced here so they are not collected between rooms
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultFloorClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultWallClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultWallClassLightned;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultEntranceClass;
+	UPROPERTY()
 	TSubclassOf<AActor> DefaultRoofClass;
 
 public:
@@ -222,6 +384,9 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Struct Room")
 	void SetParamRoomTag(FString NewValue) { RoomTag = NewValue; }
+
+	UFUNCTION(BlueprintCallable, Category = "Struct Room")
+	void SetRandomSeed(int32 NewSeed) { RandomStream.Initialize(NewSeed); }
 	//END  : Setters
 
 private:
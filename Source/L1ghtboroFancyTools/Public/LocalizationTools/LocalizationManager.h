@@ -11,6 +11,11 @@ private:
 	TSharedPtr<FJsonObject> LocalizationData;
 	FString CurrentLanguage;
 
+	// Object of the current language, resolved once per language change or load so key lookups are a single probe
+	TSharedPtr<FJsonObject> LanguageData;
+
+	void ResolveLanguageData();
+
 public:
 	// Initializae the Localization Manager
 	void Init(const FString& LanguageCode, const FString& FilePath);
@@ -18,6 +23,9 @@ public:
 	// Load localization data from JSON
 	bool LoadLocalizationData(const FString& FilePath);
 
+	// Load on a worker thread, the data is swapped in and OnLoaded called on the game thread
+	void LoadLocalizationDataAsync(const FString& FilePath, TUniqueFunction<void(bool bLoaded)> OnLoaded = nullptr);
+
 	// Get Localization string by key
 	FString GetLocalizedString(const FString& Key) const;
 
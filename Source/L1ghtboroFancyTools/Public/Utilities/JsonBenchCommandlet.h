@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "JsonBenchCommandlet.generated.h"
+
+// Row of the large benchmark document, bound through FJsonStructBinding
+USTRUCT() struct FJsonBenchRow {
+	GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = 0;
+
+    UPROPERTY()
+    float X = 0.0f;
+
+    UPROPERTY()
+    float Y = 0.0f;
+
+    UPROPERTY()
+    float Z = 0.0f;
+
+    UPROPERTY()
+    FString Name;
+
+    UPROPERTY()
+    bool bEnabled = false;
+};
+
+USTRUCT() struct FJsonBenchRows {
+	GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FJsonBenchRow> Rows;
+};
+
+// Measures parse, field access and serialize cost of the JSON paths in UJsonLibrary on generated documents
+// and writes the results as JSON for tracking over time. Runs headless:
+// UnrealEditor-Cmd <Project>.uproject -run=JsonBench -nullrhi [-Iterations=20] [-Seed=1] [-Output=<file>]
+// -Fuzz=<cases> instead checks the tape parser against TJsonReader and its vector scanners against the scalar ones
+UCLASS() class L1GHTBOROFANCYTOOLS_API UJsonBenchCommandlet : public UCommandlet {
+	GENERATED_BODY()
+
+public:
+    UJsonBenchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "JsonCookCommandlet.generated.h"
+
+// Writes the cooked .jsonbin form of every JSON file under a content directory, run before packaging:
+// UnrealEditor-Cmd <Project>.uproject -run=JsonCook [-Dir=TestData/JSON] [-Clean]
+UCLASS() class L1GHTBOROFANCYTOOLS_API UJsonCookCommandlet : public UCommandlet {
+	GENERATED_BODY()
+
+public:
+    UJsonCookCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -2,18 +2,61 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Async/Future.h"
 #include "JsonLibrary.generated.h"
 
+class IJsonVisitor;
+class FJsonTapeDocument;
+class FJsonPathQuery;
+
+// Objects of a batch in the order their files were requested, null where a file failed to load
+using FOnJSONFilesLoaded = TUniqueFunction<void(TArray<TSharedPtr<FJsonObject>>&& Objects)>;
+
 UCLASS() class L1GHTBOROFANCYTOOLS_API UJsonLibrary : public UObject {
 	GENERATED_BODY()
 
 public:
+    // Goes through LoadJSONDocument unless Json.Utf8Load is off
     static TSharedPtr<FJsonObject> LoadJSONFromFile(const FString& FilePath);
 
+    // Read and parse on a thread pool worker, the future is fulfilled there
+    static TFuture<TSharedPtr<FJsonObject>> LoadJSONFromFileAsync(const FString& FilePath);
+
+    // Load every file on its own worker in parallel, OnLoaded runs on the game thread once all of them are done
+    static void LoadJSONFilesAsync(const TArray<FString>& FilePaths, FOnJSONFilesLoaded OnLoaded);
+
+    // Map the file and parse its UTF-8 bytes in place, strings are only decoded when read.
+    // Reads the cooked form next to the file instead when Json.UseCooked allows it
+    static TSharedPtr<FJsonTapeDocument> LoadJSONDocument(const FString& FilePath);
+
+    // Where the JsonCook commandlet puts the cooked form of a JSON file
+    static FString GetCookedJSONPath(const FString& AbsoluteFilePath);
+
+    // Writes UTF-8 into a temp file beside FilePath and moves it over FilePath, so a crash never leaves half a file
     static bool SaveJSONToFile(const FString& FilePath, const TSharedPtr<FJsonObject>& JsonObject);
 
+    // Same on a thread pool worker, streaming straight to the temp file. Saves to a path that is still being written
+    // are coalesced, only the latest object is written and every future gets its result.
+    // JsonObject must not change until the future is ready. Every loader reads compressed files back
+    static TFuture<bool> SaveJSONToFileAsync(const FString& FilePath, const TSharedPtr<FJsonObject>& JsonObject, bool bCompress = false);
+
+    // Goes through the tape parser like LoadJSONFromFile unless Json.Utf8Load is off
     static TSharedPtr<FJsonObject> ParseJSONString(const FString& JsonString);
 
+    // Stream the events of a file to Visitor chunk by chunk without building a DOM
+    static bool StreamJSONFromFile(const FString& FilePath, IJsonVisitor& Visitor);
+
+    // Value of one root field, everything else in the file is skipped without being decoded
+    static TSharedPtr<FJsonValue> LoadJSONFieldFromFile(const FString& FilePath, const FString& FieldName);
+
+    // Decode a file straight into a USTRUCT through its cached field map, no FJsonObject is built
+    static bool LoadJSONStructFromFile(const FString& FilePath, const UScriptStruct* Struct, void* OutStructData);
+
+    template <typename StructType>
+    static bool LoadJSONStructFromFile(const FString& FilePath, StructType& OutStruct) {
+        return LoadJSONStructFromFile(FilePath, StructType::StaticStruct(), &OutStruct);
+    }
+
 public:
     static bool GetStringField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName, FString& OutString);
 
@@ -24,4 +67,9 @@ public:
     static bool GetObjectField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName, TSharedPtr<FJsonObject>& OutObject);
 
     static bool GetArrayField(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName, TArray<TSharedPtr<FJsonValue>>& OutArray);
+
+    // Nested lookups through a query compiled once, see FJsonPathQuery
+    static bool GetStringAtPath(const TSharedPtr<FJsonObject>& JsonObject, const FJsonPathQuery& Query, FString& OutString);
+
+    static bool GetValuesAtPath(const TSharedPtr<FJsonObject>& JsonObject, const FJsonPathQuery& Query, TArray<const FJsonValue*>& OutValues);
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JsonObjectWrapper.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "JsonLoadAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnJsonFilesLoadedPin, const TArray<FJsonObjectWrapper>&, Objects);
+
+// Blueprint node for UJsonLibrary::LoadJSONFilesAsync, the files load on worker threads and the pins fire on the game thread
+UCLASS() class L1GHTBOROFANCYTOOLS_API UJsonLoadAsyncAction : public UBlueprintAsyncActionBase {
+	GENERATED_BODY()
+
+public:
+    // Every file loaded, objects are in the order of the paths
+    UPROPERTY(BlueprintAssignable)
+    FOnJsonFilesLoadedPin Loaded;
+
+    // At least one file failed, its object is left empty and the others are still filled
+    UPROPERTY(BlueprintAssignable)
+    FOnJsonFilesLoadedPin Failed;
+
+    // Paths are relative to the content directory like LoadJSONFromFile
+    UFUNCTION(BlueprintCallable, Category = "JSON", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+    static UJsonLoadAsyncAction* LoadJSONFilesAsync(UObject* WorldContextObject, const TArray<FString>& FilePaths);
+
+    virtual void Activate() override;
+
+private:
+    TArray<FString> FilePaths;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/JsonTapeDocument.h"
+
+class FJsonObject;
+class FJsonValue;
+
+// One step of a compiled path
+struct FJsonPathSegment {
+    enum class EKind : uint8 {
+        // Named field of an object
+        Field,
+        // Element of an array by position
+        Index,
+        // Every field of an object or every element of an array, written as * or [*]
+        Children
+    };
+
+    EKind Kind = EKind::Field;
+    FString Name;
+
+    // Hash FJsonObject::Values uses for Name, so DOM lookups are a single FindByHash probe
+    uint32 NameHash = 0;
+
+    // Name as UTF-8 for comparisons against tape keys
+    TArray<UTF8CHAR> Utf8Name;
+
+    int32 Index = INDEX_NONE;
+};
+
+// Path into a JSON document compiled once and run many times, e.g. "Rooms.Combat.Assets[*].Directory".
+// Syntax: fields separated by '.', [N] for array elements, * or [*] for all children.
+// Results are views into the document, nothing is copied or reference counted on the way.
+class L1GHTBOROFANCYTOOLS_API FJsonPathQuery {
+public:
+    FJsonPathQuery() = default;
+
+    // Compile Path, check IsValid or GetError afterwards
+    explicit FJsonPathQuery(FStringView Path);
+
+    bool IsValid() const { return bValid; }
+    const FString& GetError() const { return Error; }
+
+    // Extend the query by a single field, taken as is without parsing, so names may contain '.' or '['
+    FJsonPathQuery& AddField(const FString& Name);
+    FJsonPathQuery& AddIndex(int32 Index);
+    FJsonPathQuery& AddChildren();
+
+    // First value the path reaches, nullptr when there is none. Field names compare case insensitive like FJsonObject does.
+    // An empty path reaches nothing, the root object is not a value of itself
+    const FJsonValue* FindFirst(const FJsonObject& Root) const;
+
+    // Every value the path reaches in document order, returns how many were added
+    int32 FindAll(const FJsonObject& Root, TArray<const FJsonValue*>& OutValues) const;
+
+    // Same on a tape document. Field names compare case sensitive like FJsonTapeValue::FindField does
+    FJsonTapeValue FindFirst(FJsonTapeValue Root) const;
+    int32 FindAll(FJsonTapeValue Root, TArray<FJsonTapeValue>& OutValues) const;
+
+    // String at the first match, false when there is none or it is not a string
+    bool FindString(const FJsonObject& Root, FString& OutString) const;
+    bool FindString(FJsonTapeValue Root, FString& OutString) const;
+
+    const TArray<FJsonPathSegment>& GetSegments() const { return Segments; }
+
+private:
+    bool Fail(const FString& Message);
+
+    TArray<FJsonPathSegment> Segments;
+    bool bValid = true;
+    FString Error;
+};
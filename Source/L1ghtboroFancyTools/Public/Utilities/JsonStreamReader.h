@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+
+// What a visitor wants the reader to do after an event
+enum class EJsonVisit : uint8 {
+    Continue,
+
+    // After OnKey: skip the value of that key. After OnObjectStart / OnArrayStart: skip the rest of the container, its end event included.
+    // Skipped values are still validated but never decoded
+    SkipValue,
+
+    // End the read right away, Read still returns true
+    Stop
+};
+
+// Receiver of streaming JSON events. String views are only valid for the duration of the call
+class L1GHTBOROFANCYTOOLS_API IJsonVisitor {
+public:
+    virtual ~IJsonVisitor() = default;
+
+    virtual EJsonVisit OnObjectStart() { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnObjectEnd() { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnArrayStart() { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnArrayEnd() { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnKey(FStringView Key) { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnString(FStringView Value) { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnNumber(double Value) { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnBool(bool bValue) { return EJsonVisit::Continue; }
+    virtual EJsonVisit OnNull() { return EJsonVisit::Continue; }
+};
+
+// Pull parser for UTF-8 JSON that reads its input in fixed size chunks and never builds a DOM.
+// Memory stays at one chunk, one container stack entry per nesting level and the longest string or key.
+class L1GHTBOROFANCYTOOLS_API FJsonStreamReader {
+public:
+    static constexpr int32 DefaultChunkSize = 64 * 1024;
+    static constexpr int32 MaxDepth = 512;
+
+    // Read from the current position of an open file to its end, the handle must outlive the reader
+    explicit FJsonStreamReader(IFileHandle& InFile, int32 ChunkSize = DefaultChunkSize);
+
+    // Read from bytes already in memory, they must outlive the reader
+    explicit FJsonStreamReader(TArrayView<const uint8> InBytes);
+
+    // Send the events of the whole document to Visitor, false on malformed input or a read error
+    bool Read(IJsonVisitor& Visitor);
+
+    // True when a visitor returned Stop during the last read
+    bool WasStopped() const { return bStopped; }
+
+    const FString& GetErrorMessage() const { return ErrorMessage; }
+
+    // Byte offset the error was found at
+    int64 GetErrorOffset() const { return ErrorOffset; }
+
+private:
+    enum class EState : uint8 {
+        ExpectValue,
+        ExpectValueOrArrayEnd,
+        ExpectKey,
+        ExpectKeyOrObjectEnd,
+        ExpectColon,
+        ExpectCommaOrEnd,
+        Done
+    };
+
+    bool Refill();
+    bool PeekByte(uint8& OutByte);
+    bool NextByte(uint8& OutByte);
+
+    // Next byte that is not whitespace, false at the end of the input
+    bool NextToken(uint8& OutByte);
+
+    bool ParseValue(uint8 First, IJsonVisitor& Visitor);
+    bool ParseString(bool bDecode);
+    bool ParseNumber(uint8 First, double& OutValue);
+    bool ParseLiteral(const char* Rest);
+    bool OpenContainer(bool bObject, bool bSilent, IJsonVisitor& Visitor);
+    bool CloseContainer(bool bObject, IJsonVisitor& Visitor);
+    bool ReadHexQuad(uint32& OutCodePoint);
+    void AppendCodePoint(uint32 CodePoint);
+
+    // Apply what the visitor answered, false when reading has to stop
+    bool Handle(EJsonVisit Visit, bool bContainerStart);
+
+    // State after a complete value at the current depth
+    void FinishValue() { State = Stack.Num() == 0 ? EState::Done : EState::ExpectCommaOrEnd; }
+
+    bool IsSkipping() const { return SkipDepth != INDEX_NONE; }
+
+    bool Fail(const TCHAR* Message);
+
+    IFileHandle* File = nullptr;
+    int64 FileRemaining = 0;
+
+    // Current chunk, or the whole input when reading from memory
+    TArray<uint8> ChunkStorage;
+    TArrayView<const uint8> Chunk;
+    int32 Position = 0;
+    int64 ChunkOffset = 0;
+
+    // Open containers, true for objects
+    TArray<bool, TInlineAllocator<32>> Stack;
+    EState State = EState::ExpectValue;
+
+    // Depth below which events are suppressed, INDEX_NONE when nothing is being skipped
+    int32 SkipDepth = INDEX_NONE;
+    bool bSkipNextValue = false;
+    bool bStopped = false;
+
+    // Raw bytes of the current string and their decoded form, reused by every string
+    TArray<UTF8CHAR> StringBytes;
+    FString StringValue;
+
+    FString ErrorMessage;
+    int64 ErrorOffset = 0;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
+#include "Utilities/JsonTapeDocument.h"
+
+class FField;
+class FProperty;
+class UScriptStruct;
+
+// Property of a struct together with the name it is matched by, lower cased UTF-8
+struct FJsonStructField {
+    FProperty* Property = nullptr;
+    TArray<UTF8CHAR> Name;
+    uint32 Hash = 0;
+
+    // Next field with the same hash, INDEX_NONE at the end of the chain
+    int32 NextInBucket = INDEX_NONE;
+};
+
+// Lookup from JSON keys to the properties of one struct, built once per struct.
+// Keys match property names case insensitively like FJsonObjectConverter does, without decoding the key
+class L1GHTBOROFANCYTOOLS_API FJsonStructFieldMap {
+public:
+    explicit FJsonStructFieldMap(const UScriptStruct* Struct);
+
+    const FJsonStructField* Find(FUtf8StringView Key) const;
+
+    int32 Num() const { return Fields.Num(); }
+
+    // Whether Struct still has the properties the map was built from, a recompiled user defined struct does not
+    bool MatchesLayout(const UScriptStruct* Struct) const;
+
+    static uint32 HashKey(FUtf8StringView Key);
+
+private:
+    TArray<FJsonStructField> Fields;
+
+    // First field of every hash
+    TMap<uint32, int32> Buckets;
+
+    // Layout stamp, compared without touching the properties, which may already be freed
+    const FField* FirstProperty = nullptr;
+    int32 StructureSize = 0;
+};
+
+// Decodes tape values straight into USTRUCT memory, without an FJsonObject in between.
+// Field maps are cached per struct and dropped when structs are reinstanced or change layout, safe to use from any thread.
+class L1GHTBOROFANCYTOOLS_API FJsonStructBinding {
+public:
+    // Fill the fields of StructData found in Object, fields missing from the JSON keep their value.
+    // False when a field had a value of the wrong type, every other field is still bound
+    static bool BindStruct(FJsonTapeValue Object, const UScriptStruct* Struct, void* StructData);
+
+    template <typename StructType>
+    static bool BindStruct(FJsonTapeValue Object, StructType& OutStruct) {
+        return BindStruct(Object, StructType::StaticStruct(), &OutStruct);
+    }
+
+    // Cached map of the struct, rebuilt when the struct no longer matches it
+    static TSharedRef<const FJsonStructFieldMap> GetFieldMap(const UScriptStruct* Struct);
+
+    static void ResetFieldMaps();
+
+private:
+    static bool BindProperty(FJsonTapeValue Value, FProperty* Property, void* PropertyData);
+    static bool BindValue(FJsonTapeValue Value, FProperty* Property, void* ValueData);
+
+    // Hot reload, live coding and editor reinstancing free the properties the maps point at
+    static void RegisterInvalidation();
+
+    static FRWLock FieldMapsLock;
+    static TMap<TObjectKey<UScriptStruct>, TSharedRef<const FJsonStructFieldMap>> FieldMaps;
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class FJsonValue;
+class FJsonTapeDocument;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+enum class EJsonTapeType : uint8 {
+    Invalid,
+    Null,
+    True,
+    False,
+    Number,
+    String,
+    ObjectStart,
+    ObjectEnd,
+    ArrayStart,
+    ArrayEnd
+};
+
+// View of one value on a document tape. Cheap to copy, only valid while the document lives
+class L1GHTBOROFANCYTOOLS_API FJsonTapeValue {
+public:
+    FJsonTapeValue() = default;
+    FJsonTapeValue(const FJsonTapeDocument* InDocument, int32 InIndex) : Document(InDocument), Index(InIndex) {}
+
+    bool IsValid() const { return Document != nullptr and Index != INDEX_NONE; }
+
+    EJsonTapeType GetType() const;
+    bool IsNull() const { return GetType() == EJsonTapeType::Null; }
+    bool IsBool() const { return GetType() == EJsonTapeType::True or GetType() == EJsonTapeType::False; }
+    bool IsNumber() const { return GetType() == EJsonTapeType::Number; }
+    bool IsString() const { return GetType() == EJsonTapeType::String; }
+    bool IsObject() const { return GetType() == EJsonTapeType::ObjectStart; }
+    bool IsArray() const { return GetType() == EJsonTapeType::ArrayStart; }
+
+    double AsNumber(double Default = 0.0) const;
+    bool AsBool(bool bDefault = false) const;
+
+    // Decoded string, the only place a string value is converted and allocated
+    FString AsString() const;
+
+    // Raw UTF-8 bytes between the quotes, escape sequences left as they are
+    FUtf8StringView AsRawString() const;
+
+    // True when the string has no escape sequences, so its raw bytes are its value
+    bool IsPlainString() const;
+
+    // Compare a string value without decoding it
+    bool StringEquals(FUtf8StringView Other) const;
+
+    // Fields of an object or elements of an array, a container with more than 16M children reports 16M
+    int32 Num() const;
+
+    // Value of a field, invalid when this is no object or the field is missing. Keys compare case sensitive
+    FJsonTapeValue FindField(FUtf8StringView Key) const;
+    FJsonTapeValue FindField(FStringView Key) const;
+
+    // Element of an array by position, walks the array
+    FJsonTapeValue GetElement(int32 ElementIndex) const;
+
+    // Visit fields in order, return false from the visitor to stop early
+    void ForEachField(TFunctionRef<bool(FJsonTapeValue Key, FJsonTapeValue Value)> Visitor) const;
+    void ForEachElement(TFunctionRef<bool(FJsonTapeValue Element)> Visitor) const;
+
+    // Build the classic DOM for this value and everything below it
+    TSharedPtr<FJsonValue> ToJsonValue() const;
+    TSharedPtr<FJsonObject> ToJsonObject() const;
+
+    // Tape index of the value following this one and everything below it
+    int32 GetNextIndex() const;
+
+    int32 GetIndex() const { return Index; }
+
+private:
+    const FJsonTapeDocument* Document = nullptr;
+    int32 Index = INDEX_NONE;
+};
+
+// JSON document parsed from UTF-8 bytes into a flat tape of 64 bit words, without a DOM and without widening to UTF-16.
+// The bytes are memory mapped or read into a single buffer, strings stay in them until a caller asks for one.
+//
+// Tape words carry the type in the top byte:
+//   String       [offset of the first byte after the quote] [length | escaped bit 63]
+//   Number       [] [bits of the double]
+//   ObjectStart  [child count << 32 | index after the matching end], children are key / value pairs
+//   ArrayStart   [child count << 32 | index after the matching end]
+//   ObjectEnd / ArrayEnd [index of the matching start]
+//   Null / True / False  []
+//
+// The cooked form is the tape written out as is, followed by the string bytes with every distinct key stored once.
+// It is read in place, so loading a cooked file costs a mapping and one validation pass over the words.
+class L1GHTBOROFANCYTOOLS_API FJsonTapeDocument {
+public:
+    static constexpr int32 MaxDepth = 512;
+
+    FJsonTapeDocument();
+    ~FJsonTapeDocument();
+
+    FJsonTapeDocument(const FJsonTapeDocument&) = delete;
+    FJsonTapeDocument& operator=(const FJsonTapeDocument&) = delete;
+
+    // Map the file, or read it into one buffer where mapping is not available, and parse it.
+    // Cooked files are recognized by their header and read without parsing
+    bool LoadFile(const FString& AbsoluteFilePath);
+
+    // Copy the bytes into the document and parse them
+    bool ParseBytes(TArray<uint8>&& Bytes);
+
+    // Parse bytes owned by the caller, they must outlive the document
+    bool ParseView(TArrayView<const uint8> Bytes);
+
+    FJsonTapeValue GetRoot() const { return FJsonTapeValue(this, Words.Num() > 0 ? 0 : INDEX_NONE); }
+
+    const FString& GetErrorMessage() const { return ErrorMessage; }
+    int64 GetErrorOffset() const { return ErrorOffset; }
+
+    // Tape, owned bytes and mapping bookkeeping, mapped pages are not counted
+    SIZE_T GetAllocatedSize() const;
+
+    int32 GetTapeLength() const { return Words.Num(); }
+
+    bool IsMapped() const { return MappedRegion.IsValid(); }
+
+    // Cooked form of the document, see above. The size and modification time of the text it came from go into the header
+    bool WriteCooked(TArray<uint8>& OutBytes, int64 SourceSize = INDEX_NONE, const FDateTime& SourceTimestamp = FDateTime()) const;
+
+    // Whether the document was read from a cooked file whose header names this source, false for text and unstamped files
+    bool IsCookedFrom(int64 SourceSize, const FDateTime& SourceTimestamp) const;
+
+    // Size of the text named in the cooked header, INDEX_NONE for text and unstamped files
+    int64 GetCookedSourceSize() const { return CookedSourceSize; }
+
+    static bool IsCooked(TArrayView<const uint8> Bytes);
+
+    // Zlib container for JSON text or cooked bytes, unpacked by the loaders before parsing
+    static bool WriteCompressed(TArrayView<const uint8> Bytes, TArray<uint8>& OutBytes);
+
+    static bool IsCompressed(TArrayView<const uint8> Bytes);
+
+    // Bytes IsCompressed needs to tell a compressed file apart
+    static constexpr int32 CompressedHeaderSize = 16;
+
+    // Unpack a container written by WriteCompressed, for readers that take the text without a tape document
+    static bool Uncompress(TArrayView<const uint8> Bytes, TArray<uint8>& OutBytes);
+
+    void Reset();
+
+private:
+    friend class FJsonTapeValue;
+
+    static constexpr uint64 PayloadMask = (uint64(1) << 56) - 1;
+    static constexpr uint64 EscapedBit = uint64(1) << 63;
+    static constexpr uint32 MaxChildCount = 0xFFFFFF;
+
+    static uint64 MakeWord(EJsonTapeType Type, uint64 Payload = 0) { return (uint64(Type) << 56) | (Payload & PayloadMask); }
+    static EJsonTapeType TypeOf(uint64 Word) { return static_cast<EJsonTapeType>(Word >> 56); }
+    EJsonTapeType GetWordType(int32 TapeIndex) const { return TypeOf(Words[TapeIndex]); }
+    uint64 GetWordPayload(int32 TapeIndex) const { return Words[TapeIndex] & PayloadMask; }
+
+    // Parse the source bytes, or read them in place when they are cooked
+    bool Parse();
+    bool ReadCooked();
+    bool Decompress();
+    bool ParseString(int32& Cursor);
+    bool ParseNumber(int32& Cursor);
+    bool ParseLiteral(int32& Cursor, const char* Text, EJsonTapeType Type);
+    bool Fail(const TCHAR* Message, int64 Offset);
+
+    // Hot loops of the parser, vectorized unless Json.SimdScan is off
+    int32 SkipWhitespace(int32 Cursor) const;
+    int32 FindStringSpecial(int32 Cursor) const;
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray<uint8> OwnedBytes;
+    TArrayView<const uint8> Source;
+
+    // Tape built by the parser, cooked documents leave it empty and read their words in place
+    TArray<uint64> Tape;
+    TConstArrayView<uint64> Words;
+
+    FString ErrorMessage;
+    int64 ErrorOffset = 0;
+
+    // Source stamp from the header of a cooked file, INDEX_NONE otherwise
+    int64 CookedSourceSize = INDEX_NONE;
+    int64 CookedSourceTicks = 0;
+
+    // Json.SimdScan as read at the start of the current parse
+    bool bSimdScan = false;
+};